@@ -0,0 +1,178 @@
+/*
+	Compares decoding of bodies with the chunked transfer encoding with the implementation 
+	that was used before the state machine (reference::ChunkyBodyParser), for several 
+	distributions of chunk sizes. The body is received in packets of 4 KiB.
+	Build with -DCPP20_HTTP_CLIENT_BUILD_BENCHMARKS=ON and run in release mode.
+*/
+
+#include <cpp20_http_client.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace http_client;
+
+namespace reference {
+
+class ChunkyBodyParser {
+public:
+	[[nodiscard]]
+	std::optional<utils::DataVector> parse_new_data(std::span<std::byte const> const new_data) {
+		if (has_returned_result_) {
+			return {};
+		}
+		if (is_finished_) {
+			has_returned_result_ = true;
+			return std::move(result_);
+		}
+		
+		auto cursor = start_parse_offset_;
+		
+		while (true) {
+			if (cursor >= new_data.size()) {
+				start_parse_offset_ = cursor - new_data.size();
+				return {};
+			}
+			if (auto const cursor_offset = parse_next_part_(new_data.subspan(cursor))) {
+				cursor += cursor_offset;
+			}
+			else {
+				has_returned_result_ = true;
+				return std::move(result_);
+			}
+		}
+	}
+
+private:
+	static constexpr auto newline = std::string_view{"\r\n"};
+
+	[[nodiscard]]
+	std::size_t parse_next_part_(std::span<std::byte const> const new_data) {
+		if (chunk_size_left_) {
+			return parse_chunk_body_part_(new_data);
+		}
+		else return parse_chunk_separator_part_(new_data);
+	}
+
+	[[nodiscard]]
+	std::size_t parse_chunk_body_part_(std::span<std::byte const> const new_data) {
+		if (chunk_size_left_ > new_data.size())
+		{
+			chunk_size_left_ -= new_data.size();
+			utils::append_to_vector(result_, new_data);
+			return new_data.size();
+		}
+		else {
+			utils::append_to_vector(result_, new_data.first(chunk_size_left_));
+
+			auto const part_end = chunk_size_left_ + newline.size();
+			chunk_size_left_ = 0;
+			return part_end;
+		}
+	}
+
+	[[nodiscard]]
+	std::size_t parse_chunk_separator_part_(std::span<std::byte const> const new_data) {
+		auto const data_string = utils::data_to_string(new_data);
+
+		auto const first_newline_character_pos = data_string.find(newline[0]);
+		
+		if (first_newline_character_pos == std::string_view::npos) {
+			chunk_size_string_buffer_ += data_string;
+			return new_data.size();
+		}
+		else if (chunk_size_string_buffer_.empty()) {
+			parse_chunk_size_left_(data_string.substr(0, first_newline_character_pos));
+		}
+		else {
+			chunk_size_string_buffer_ += data_string.substr(0, first_newline_character_pos);
+			parse_chunk_size_left_(chunk_size_string_buffer_);
+			chunk_size_string_buffer_.clear();
+		}
+
+		if (chunk_size_left_ == 0) {
+			is_finished_ = true;
+			return 0;
+		}
+		
+		return first_newline_character_pos + newline.size();
+	}
+
+	void parse_chunk_size_left_(std::string_view const string) {
+		if (auto const result = utils::string_to_integral<std::size_t>(string, 16)) {
+			chunk_size_left_ = *result;
+		}
+		else throw errors::ResponseParsingFailed{"Failed parsing http body chunk size."};
+	}
+	
+	utils::DataVector result_;
+
+	bool is_finished_{false};
+	bool has_returned_result_{false};
+
+	std::size_t start_parse_offset_{};
+	
+	std::string chunk_size_string_buffer_;
+	std::size_t chunk_size_left_{};
+};
+
+} // namespace reference
+
+/*
+	Creates a chunked body of about 1 MiB whose chunk sizes are drawn from chunk_size_distribution.
+*/
+template<typename Distribution_>
+[[nodiscard]]
+std::string make_chunked_body(Distribution_ chunk_size_distribution) {
+	constexpr auto body_size = std::size_t{1} << 20;
+
+	auto random_engine = std::mt19937{1234};
+	auto result = std::string{};
+	for (auto size = std::size_t{}; size < body_size;) {
+		auto const chunk_size = std::max(std::size_t{1}, static_cast<std::size_t>(chunk_size_distribution(random_engine)));
+		result += std::format("{:x}\r\n{}\r\n", chunk_size, std::string(chunk_size, 'x'));
+		size += chunk_size;
+	}
+	return result += "0\r\n\r\n";
+}
+
+template<typename Parser_>
+[[nodiscard]]
+std::size_t parse_chunked_body(std::string_view const body) {
+	constexpr auto packet_size = std::size_t{1} << 12;
+
+	auto parser = Parser_{};
+	auto const data = utils::string_to_data<std::byte>(body);
+	for (auto position = std::size_t{}; position < data.size(); position += packet_size) {
+		if (auto const result = parser.parse_new_data(data.subspan(position, std::min(packet_size, data.size() - position)))) {
+			return result->size();
+		}
+	}
+	return 0;
+}
+
+void run_benchmark(std::string_view const name, std::string_view const body) {
+	constexpr auto iterations = 200;
+
+	for (auto const& [parser_name, parse] : {
+		std::pair{"reference", &parse_chunked_body<reference::ChunkyBodyParser>}, 
+		std::pair{"current", &parse_chunked_body<algorithms::ChunkyBodyParser>}
+	}) {
+		auto checksum = std::size_t{};
+		auto const start_time = std::chrono::steady_clock::now();
+		for (auto i = 0; i < iterations; ++i) {
+			checksum += parse(body);
+		}
+		auto const time = std::chrono::duration<double, std::micro>{std::chrono::steady_clock::now() - start_time};
+
+		std::cout << std::format("{:<28} {:<10} {:>8.1f} µs/body (checksum {})\n", name, parser_name, time.count()/iterations, checksum);
+	}
+}
+
+int main() {
+	run_benchmark("chunks of 1-16 bytes", make_chunked_body(std::uniform_int_distribution<std::size_t>{1, 16}));
+	run_benchmark("chunks of 256 B-4 KiB", make_chunked_body(std::uniform_int_distribution<std::size_t>{256, 4096}));
+	run_benchmark("chunks of 64 KiB", make_chunked_body([](auto&) { return std::size_t{1} << 16; }));
+	run_benchmark("log-normal chunk sizes", make_chunked_body(std::lognormal_distribution<double>{6.0, 2.0}));
+}
@@ -0,0 +1,106 @@
+/*
+	Compares parsing of response headers with the implementation that was used
+	before the single-pass tokenizer (reference::parse_headers_string).
+	Build with -DCPP20_HTTP_CLIENT_BUILD_BENCHMARKS=ON and run in release mode.
+*/
+
+#include <cpp20_http_client.hpp>
+
+#include <chrono>
+#include <iostream>
+
+using namespace http_client;
+
+namespace reference {
+
+[[nodiscard]]
+std::vector<Header> parse_headers_string(std::string_view const headers) {
+	auto result = std::vector<Header>();
+
+	std::ranges::copy(
+		headers 
+		| std::views::split('\n') | std::views::transform(utils::range_to_string_view)
+		| std::views::transform(algorithms::parse_header) | utils::filter_true | utils::dereference_move,
+		std::back_inserter(result)
+	);
+
+	return result;
+}
+
+[[nodiscard]]
+StatusLine parse_status_line(std::string_view const line) {
+	auto status_line = StatusLine{};
+
+	auto cursor = std::size_t{};
+	
+	if (auto const http_version_end = line.find(' '); http_version_end != std::string_view::npos)
+	{
+		status_line.http_version = line.substr(0, http_version_end);
+		cursor = http_version_end + 1;
+	}
+	else return status_line;
+
+	if (auto const status_code_end = line.find(' ', cursor); status_code_end != std::string_view::npos) 
+	{
+		if (auto const status_code = utils::string_to_integral<int>(line.substr(cursor, status_code_end))) 
+		{
+			status_line.status_code = static_cast<StatusCode>(*status_code);
+		}
+		else return status_line;
+		cursor = status_code_end + 1;
+	}
+	else return status_line;
+	
+	status_line.status_message = line.substr(cursor, line.find_last_not_of("\r\n ") + 1 - cursor);
+	return status_line;
+}
+
+} // namespace reference
+
+constexpr auto status_line = std::string_view{"HTTP/1.1 200 OK\r\n"};
+constexpr auto headers = std::string_view{
+	"\r\nDate: Mon, 18 Oct 2021 12:00:00 GMT"
+	"\r\nContent-Type: application/json; charset=utf-8"
+	"\r\nContent-Length: 1234"
+	"\r\nConnection: keep-alive"
+	"\r\nCache-Control: private, max-age=0, must-revalidate"
+	"\r\nETag: W/\"4d2-1a2b3c4d5e6f\""
+	"\r\nVary: Accept-Encoding, Origin"
+	"\r\nServer: nginx/1.21.3"
+	"\r\nStrict-Transport-Security: max-age=31536000; includeSubDomains"
+	"\r\nX-Content-Type-Options: nosniff"
+	"\r\nX-Frame-Options: DENY"
+	"\r\nX-Request-Id: 7f3c2a1b-9d8e-4f6a-b5c4-3e2d1f0a9b8c"
+	"\r\nAccess-Control-Allow-Origin: *"
+	"\r\nSet-Cookie: session=abcdef0123456789; Path=/; HttpOnly; Secure"
+	"\r\nLast-Modified: Sun, 17 Oct 2021 08:30:00 GMT"
+};
+
+template<typename Function_>
+void run_benchmark(std::string_view const name, Function_ const& function) {
+	constexpr auto iterations = 200'000;
+
+	auto checksum = std::size_t{};
+	auto const start_time = std::chrono::steady_clock::now();
+	for (auto i = 0; i < iterations; ++i) {
+		checksum += function();
+	}
+	auto const time = std::chrono::duration<double, std::nano>{std::chrono::steady_clock::now() - start_time};
+
+	std::cout << std::format("{:<40} {:>8.1f} ns/iteration (checksum {})\n", name, time.count()/iterations, checksum);
+}
+
+int main() {
+	run_benchmark("parse_headers_string (reference)", [] { 
+		return reference::parse_headers_string(headers).size(); 
+	});
+	run_benchmark("parse_headers_string", [] { 
+		return algorithms::parse_headers_string(headers).size(); 
+	});
+	run_benchmark("parse_status_line (reference)", [] { 
+		return static_cast<std::size_t>(reference::parse_status_line(status_line).status_code); 
+	});
+	run_benchmark("parse_status_line", [] { 
+		return static_cast<std::size_t>(algorithms::parse_status_line(status_line).status_code); 
+	});
+}
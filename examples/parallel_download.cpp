@@ -0,0 +1,18 @@
+#include <cpp20_http_client.hpp>
+
+int main() {
+	auto options = http_client::ParallelDownloadOptions{};
+	options.number_of_connections = 8;
+
+	try {
+		auto const response = http_client::download_file_parallel(
+			"https://github.com/avocadoboi/cpp20-http-client/archive/refs/heads/master.zip", 
+			"cpp20-http-client.zip",
+			options
+		);
+		std::cout << "Status code: " << static_cast<int>(response.get_status_code()) << '\n';
+	}
+	catch (http_client::errors::ConnectionFailed const& error) {
+		std::cout << "The download failed with error \"" << error.what() << "\"\n";
+	}
+}
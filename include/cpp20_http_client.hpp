@@ -26,15 +26,22 @@ SOFTWARE.
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
 #include <charconv>
 #include <chrono>
 #include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
 #include <format>
 #include <fstream>
 #include <functional>
 #include <future>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <memory_resource>
 #include <ranges>
 #include <span>
 #include <stdexcept>
@@ -332,13 +339,129 @@ std::span<Byte_ const> string_to_data(std::string_view const string) {
 
 using DataVector = std::vector<std::byte>;
 
+namespace pmr {
+
+/*
+	Byte data that is allocated from a memory resource, like the other containers in std::pmr.
+*/
+using DataVector = std::pmr::vector<std::byte>;
+
+} // namespace pmr
+
 //---------------------------------------------------------
 
+/*
+	Replaces object with value by destroying it and move constructing it again, so that 
+	object also takes over the allocator of value. Assigning a std::pmr container keeps its allocator.
+*/
 template<std::movable T>
-void append_to_vector(std::vector<T>& vector, std::span<T const> const data) {
+void reconstruct(T& object, T&& value) noexcept {
+	static_assert(std::is_nothrow_move_constructible_v<T>);
+	std::destroy_at(&object);
+	std::construct_at(&object, std::move(value));
+}
+
+template<std::movable T, typename Allocator_>
+void append_to_vector(std::vector<T, Allocator_>& vector, std::span<T const> const data) {
 	vector.insert(vector.end(), data.begin(), data.end());
 }
 
+/*
+	Byte data that is stored in a sequence of blocks of a fixed size instead of in one contiguous buffer.
+	Appending never moves the data that has already been stored, so unlike with a vector, 
+	the total amount of copying stays proportional to the size of the data, and at most 
+	one partially filled block is allocated at a time.
+*/
+class SegmentedData {
+public:
+	static constexpr auto default_segment_size = std::size_t{1} << 16;
+
+	/*
+		Returns the blocks of the data as a range of std::span<std::byte const>.
+		All blocks except the last one contain exactly get_segment_size() bytes.
+	*/
+	[[nodiscard]]
+	auto get_segments() const {
+		return segments_ | std::views::transform([](pmr::DataVector const& segment) { return std::span<std::byte const>{segment}; });
+	}
+	[[nodiscard]]
+	std::size_t size() const noexcept {
+		return size_;
+	}
+	[[nodiscard]]
+	bool empty() const noexcept {
+		return size_ == 0;
+	}
+	[[nodiscard]]
+	std::size_t get_segment_size() const noexcept {
+		return segment_size_;
+	}
+	/*
+		Only affects blocks that are allocated after this call.
+	*/
+	void set_segment_size(std::size_t const segment_size) noexcept {
+		segment_size_ = std::max(segment_size, std::size_t{1});
+	}
+	[[nodiscard]]
+	std::pmr::polymorphic_allocator<> get_allocator() const noexcept {
+		return segments_.get_allocator();
+	}
+
+	void append(std::span<std::byte const> data) {
+		while (!data.empty()) {
+			if (segments_.empty() || segments_.back().size() >= segment_size_) {
+				segments_.emplace_back().reserve(segment_size_);
+			}
+			auto& segment = segments_.back();
+			auto const part = data.first(std::min(data.size(), segment_size_ - segment.size()));
+			append_to_vector(segment, part);
+			size_ += part.size();
+			data = data.subspan(part.size());
+		}
+	}
+	/*
+		Copies the data into one contiguous buffer that is allocated with allocator.
+	*/
+	[[nodiscard]]
+	pmr::DataVector flatten(std::pmr::polymorphic_allocator<> const allocator = {}) const {
+		auto result = pmr::DataVector(allocator);
+		result.reserve(size_);
+		for (auto const& segment : segments_) {
+			append_to_vector(result, std::span<std::byte const>{segment});
+		}
+		return result;
+	}
+	/*
+		Frees all blocks.
+	*/
+	void clear() noexcept {
+		segments_.clear();
+		size_ = 0;
+	}
+
+	/*
+		Compares the data, regardless of how it is divided into blocks.
+	*/
+	[[nodiscard]]
+	bool operator==(SegmentedData const& other) const {
+		return size_ == other.size_ && std::ranges::equal(get_segments() | std::views::join, other.get_segments() | std::views::join);
+	}
+
+	SegmentedData() = default;
+	explicit SegmentedData(std::pmr::polymorphic_allocator<> const allocator) :
+		segments_(allocator)
+	{}
+	explicit SegmentedData(std::size_t const segment_size, std::pmr::polymorphic_allocator<> const allocator = {}) :
+		segment_size_{std::max(segment_size, std::size_t{1})},
+		segments_(allocator)
+	{}
+
+private:
+	std::size_t segment_size_{default_segment_size};
+	std::size_t size_{};
+	std::pmr::vector<pmr::DataVector> segments_;
+};
+
 //---------------------------------------------------------
 
 template<typename T>
@@ -378,6 +501,19 @@ auto copy_byte_data(Data_ const& data, Range_& range)
 	}
 }
 
+/*
+	Concatenates any kind of sequence of trivial byte-sized elements like char and std::byte.
+	The arguments can be individual bytes and/or ranges of bytes.
+	Returns a utils::pmr::DataVector (std::pmr::vector<std::byte>) that is allocated with allocator.
+*/
+template<IsByteData ... T>
+[[nodiscard]]
+pmr::DataVector concatenate_byte_data(std::allocator_arg_t, std::pmr::polymorphic_allocator<> const allocator, T const& ... arguments) {
+	auto buffer = pmr::DataVector((size_of_byte_data(arguments) + ...), allocator);
+	auto buffer_span = std::span{buffer};
+	((buffer_span = std::span{copy_byte_data(arguments, buffer_span), buffer_span.end()}), ...);
+	return buffer;
+}
 /*
 	Concatenates any kind of sequence of trivial byte-sized elements like char and std::byte.
 	The arguments can be individual bytes and/or ranges of bytes.
@@ -418,24 +554,248 @@ void write_to_file(DataRange_ const& data, std::string const& file_name) {
 	file_stream.write(reinterpret_cast<char const*>(std::ranges::data(data)), static_cast<std::streamsize>(std::ranges::size(data)));
 }
 
+/*
+	An immutable string that is shared by its copies, so that copying it never allocates.
+	The characters are stored in the same allocation as the reference count.
+*/
+class SharedString {
+public:
+	[[nodiscard]]
+	std::string_view get() const noexcept {
+		return {data_.get(), size_};
+	}
+
+	SharedString() = default;
+	/*
+		Copies string into memory that is allocated with allocator.
+	*/
+	explicit SharedString(std::string_view const string, std::pmr::polymorphic_allocator<> const allocator = {}) :
+		size_{string.size()}
+	{
+		if (!string.empty()) {
+			auto data = std::allocate_shared<char[]>(std::pmr::polymorphic_allocator<char>{allocator.resource()}, string.size());
+			std::ranges::copy(string, data.get());
+			data_ = std::move(data);
+		}
+	}
+
+private:
+	std::shared_ptr<char const[]> data_;
+	std::size_t size_{};
+};
+
+/*
+	Converts a UTF-8 encoded string to a file system path.
+*/
+[[nodiscard]]
+inline std::filesystem::path utf8_to_path(std::string_view const string) {
+	return std::filesystem::path{std::u8string_view{reinterpret_cast<char8_t const*>(string.data()), string.size()}};
+}
+
+/*
+	A file that binary data is written to as it becomes available.
+	This is used to stream response bodies directly to disk.
+	Errors are reported by throwing std::system_error.
+*/
+class OutputFile {
+public:
+	enum class Mode {
+		// Any existing contents of the file are discarded.
+		Truncate,
+		// Data is written after any existing contents of the file.
+		Append,
+	};
+
+	/*
+		Appends data to the end of the file.
+	*/
+	void write(std::span<std::byte const> data);
+	/*
+		Writes data at a position in the file.
+		Different parts of the file can be written to concurrently from different threads.
+	*/
+	void write_at(std::span<std::byte const> data, std::uint64_t offset);
+
+	/*
+		Reserves disk space for a file of the given size, if the platform supports it.
+		The size of the file as seen by readers does not change.
+	*/
+	void preallocate(std::uint64_t size);
+
+	/*
+		Opens a file for writing, creating it if it doesn't exist.
+	*/
+	explicit OutputFile(std::string_view path, Mode mode = Mode::Truncate);
+	~OutputFile(); // = default in .cpp
+
+	OutputFile(OutputFile&&) noexcept; // = default in .cpp
+	OutputFile& operator=(OutputFile&&) noexcept; // = default in .cpp
+
+	OutputFile(OutputFile const&) = delete;
+	OutputFile& operator=(OutputFile const&) = delete;
+
+private:
+	class Implementation;
+	std::unique_ptr<Implementation> implementation_;
+};
+
 //---------------------------------------------------------
 
 constexpr auto filter_true = std::views::filter([](auto const& x){ return static_cast<bool>(x); });
 constexpr auto dereference_move = std::views::transform([](auto&& x) { return std::move(*x); });
 
+/*
+	Maps every byte value to its ASCII lowercase equivalent.
+	Bytes that are not uppercase ASCII letters map to themselves.
+*/
+inline constexpr auto ascii_lowercase_table = [] {
+	auto table = std::array<char, 256>{};
+	for (auto i = 0; i < 256; ++i) {
+		table[static_cast<std::size_t>(i)] = static_cast<char>(i >= 'A' && i <= 'Z' ? i - 'A' + 'a' : i);
+	}
+	return table;
+}();
+
+/*
+	Returns the ASCII lowercase equivalent of character.
+*/
+[[nodiscard]]
+constexpr char ascii_to_lowercase(char const character) noexcept {
+	return ascii_lowercase_table[static_cast<unsigned char>(character)];
+}
+
 /*
 	Transforms a range of chars into its lowercase equivalent.
 */
-constexpr auto ascii_lowercase_transform = std::views::transform([](char const c) { 
-	return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
-});
+constexpr auto ascii_lowercase_transform = std::views::transform(ascii_to_lowercase);
+
+/*
+	Converts the uppercase ASCII letters in 8 packed bytes to lowercase, without branching.
+	Bytes with the high bit set are left as they are.
+*/
+[[nodiscard]]
+constexpr std::uint64_t ascii_to_lowercase_8(std::uint64_t const bytes) noexcept {
+	constexpr auto ones = std::uint64_t{0x0101010101010101};
+	constexpr auto high_bits = ones*0x80;
+
+	auto const low_7_bits = bytes & ~high_bits;
+	// The high bit of each byte in is_at_least_a is set if the byte is 'A' or above, 
+	// and in is_above_z if it is above 'Z'.
+	auto const is_at_least_a = low_7_bits + ones*(0x80 - 'A');
+	auto const is_above_z = low_7_bits + ones*(0x80 - 'Z' - 1);
+	auto const is_uppercase = (is_at_least_a ^ is_above_z) & ~bytes & high_bits;
+	// 'a' - 'A' is 0x20, which is the high bit shifted right by 2.
+	return bytes | is_uppercase >> 2;
+}
 
 /*
 	Returns whether lhs and rhs are equal, regardless of casing, assuming both are encoded in ASCII.
 */
 [[nodiscard]]
 constexpr bool equal_ascii_case_insensitive(std::string_view const lhs, std::string_view const rhs) noexcept {
-	return std::ranges::equal(lhs | ascii_lowercase_transform, rhs | ascii_lowercase_transform);
+	if (lhs.size() != rhs.size()) {
+		return false;
+	}
+
+	auto position = std::size_t{};
+	if (!std::is_constant_evaluated()) {
+		// Compares 8 bytes at a time.
+		for (; position + 8 <= lhs.size(); position += 8) {
+			std::uint64_t lhs_bytes, rhs_bytes;
+			std::memcpy(&lhs_bytes, lhs.data() + position, 8);
+			std::memcpy(&rhs_bytes, rhs.data() + position, 8);
+			if (ascii_to_lowercase_8(lhs_bytes) != ascii_to_lowercase_8(rhs_bytes)) {
+				return false;
+			}
+		}
+	}
+	for (; position < lhs.size(); ++position) {
+		if (ascii_to_lowercase(lhs[position]) != ascii_to_lowercase(rhs[position])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+	Returns the FNV-1a hash of the ASCII lowercase equivalent of string, 
+	so strings that are equal according to equal_ascii_case_insensitive have the same hash.
+*/
+[[nodiscard]]
+constexpr std::uint32_t hash_ascii_case_insensitive(std::string_view const string, std::uint32_t const seed = 2166136261) noexcept {
+	auto hash = seed;
+	for (auto const character : string) {
+		hash = (hash ^ static_cast<unsigned char>(ascii_to_lowercase(character)))*16777619u;
+	}
+	return hash;
+}
+
+//---------------------------------------------------------
+
+/*
+	A string that can be used as a template argument, for example a string literal.
+*/
+template<std::size_t size_with_null_>
+struct FixedString {
+	std::array<char, size_with_null_> data;
+
+	[[nodiscard]]
+	constexpr std::string_view view() const noexcept {
+		return std::string_view{data.data(), size_with_null_ - 1};
+	}
+
+	consteval FixedString(char const (&string)[size_with_null_]) {
+		std::ranges::copy(string, data.begin());
+	}
+};
+
+/*
+	Returns whether a character can be part of a header name (a "tchar" in the HTTP specification).
+*/
+[[nodiscard]]
+constexpr bool is_header_name_character(char const character) noexcept {
+	return (character >= 'a' && character <= 'z') || (character >= 'A' && character <= 'Z') || 
+		(character >= '0' && character <= '9') || std::string_view{"!#$%&'*+-.^_`|~"}.find(character) != std::string_view::npos;
+}
+
+/*
+	Returns whether a string is a single syntactically valid header line 
+	in the format "NAME: VALUE", without a line ending.
+*/
+[[nodiscard]]
+constexpr bool is_valid_header_line(std::string_view const line) noexcept {
+	auto const colon_pos = line.find(':');
+	if (colon_pos == 0 || colon_pos == std::string_view::npos) {
+		return false;
+	}
+	if (!std::ranges::all_of(line.substr(0, colon_pos), is_header_name_character)) {
+		return false;
+	}
+	// Non-ASCII bytes are opaque data in header values, but control characters are not allowed.
+	return std::ranges::none_of(line.substr(colon_pos + 1), [](char const character) {
+		auto const byte = static_cast<unsigned char>(character);
+		return (byte < 0x20 && character != '\t') || byte == 0x7f;
+	});
+}
+
+/*
+	Concatenates header lines into a block where each line ends with CRLF, at compile time.
+	A header line that is not valid is a compile error.
+*/
+template<FixedString ... header_lines>
+[[nodiscard]]
+consteval auto make_header_block() {
+	auto result = std::array<char, (std::size_t{} + ... + (header_lines.view().size() + 2))>();
+	auto position = result.begin();
+	for (auto const line : {header_lines.view()...}) {
+		if (!is_valid_header_line(line)) {
+			throw std::invalid_argument{"Header lines must be in the format \"NAME: VALUE\" with a valid name and no line breaks."};
+		}
+		position = std::ranges::copy(line, position).out;
+		*position++ = '\r';
+		*position++ = '\n';
+	}
+	return result;
 }
 
 //---------------------------------------------------------
@@ -484,18 +844,39 @@ struct HostAndPort {
 	std::optional<Port> port;
 };
 
+/*
+	Parses a decimal port number in the range 0 to 65535.
+*/
+[[nodiscard]]
+constexpr std::optional<Port> parse_port(std::string_view const string) noexcept {
+	if (string.empty() || string.size() > 5) {
+		return {};
+	}
+	auto result = Port{};
+	for (auto const character : string) {
+		if (character < '0' || character > '9') {
+			return {};
+		}
+		result = result*10 + (character - '0');
+	}
+	if (result > 65535) {
+		return {};
+	}
+	return result;
+}
+
 /*
 	Splits a domain name into a name and an optional port.
 	For example, "localhost:8080" returns "localhost" and 8080, while
 	"google.com" returns "google.com" and no port (std::nullopt).
 */
 [[nodiscard]]
-inline HostAndPort split_domain_name(std::string_view const domain_name)
+constexpr HostAndPort split_domain_name(std::string_view const domain_name) noexcept
 {
 	if (auto const colon_position = domain_name.rfind(':');
 		colon_position != std::string_view::npos)
 	{
-		if (auto const port = string_to_integral<Port>(domain_name.substr(colon_position + 1)))
+		if (auto const port = parse_port(domain_name.substr(colon_position + 1)))
 		{
 			return HostAndPort{
 				.host{domain_name.substr(0, colon_position)},
@@ -520,7 +901,7 @@ inline HostAndPort split_domain_name(std::string_view const domain_name)
 	Splits an URL into its components.
 */
 [[nodiscard]] 
-inline UrlComponents split_url(std::string_view const url) noexcept {
+constexpr UrlComponents split_url(std::string_view const url) noexcept {
 	using namespace std::string_view_literals;
 	
 	if (url.empty()) {
@@ -584,6 +965,56 @@ inline UrlComponents split_url(std::string_view const url) noexcept {
 	return result;
 }
 
+/*
+	The positions of the components of a URL within the URL string.
+	Unlike UrlComponents, this stays valid when the string is copied or moved.
+*/
+struct UrlPositions {
+	Protocol protocol{Protocol::Unknown};
+	std::size_t host_offset{};
+	std::size_t host_size{};
+	Port port{default_port_for_protocol(Protocol::Unknown)};
+	std::size_t path_offset{};
+	// This is 0 if the URL has no path.
+	std::size_t path_size{};
+
+	[[nodiscard]]
+	constexpr bool operator==(UrlPositions const&) const noexcept = default;
+};
+
+/*
+	Splits an URL into its components and returns their positions in url.
+	If url has no protocol, default_protocol is used, and if it has no port, 
+	the default port of the protocol is used.
+*/
+[[nodiscard]]
+constexpr UrlPositions get_url_positions(std::string_view const url, Protocol const default_protocol) noexcept {
+	auto const components = split_url(url);
+
+	auto const get_offset = [url](std::string_view const part) {
+		return part.data() ? static_cast<std::size_t>(part.data() - url.data()) : std::size_t{};
+	};
+	
+	auto result = UrlPositions{};
+	result.host_offset = get_offset(components.host);
+	result.host_size = components.host.size();
+	
+	if (url.find('/', result.host_offset + result.host_size) != std::string_view::npos) {
+		result.path_offset = get_offset(components.path);
+		result.path_size = components.path.size();
+	}
+	else {
+		// There is no path, so a path would start at the end of the URL.
+		// split_url returns "/" as the path then, which does not point into the URL.
+		result.path_offset = url.find_last_not_of(" \t\r\n") + 1;
+	}
+
+	result.protocol = components.protocol == Protocol::Unknown ? default_protocol : components.protocol;
+	result.port = components.port == default_port_for_protocol(Protocol::Unknown) ? 
+		default_port_for_protocol(result.protocol) : components.port;
+	return result;
+}
+
 /*
 	Returns the file name part of a URL (or file path with only forward slashes).
 */
@@ -604,17 +1035,79 @@ constexpr std::string_view extract_filename(std::string_view const url)
 	return {};
 }
 
+/*
+	Bit flag for the characters in uri_character_classes that can be part of a URI-encoded string.
+*/
+inline constexpr auto uri_character_class_allowed = std::uint8_t{1};
+/*
+	Bit flag for the characters in uri_character_classes that never need to be encoded, even in a URI component.
+*/
+inline constexpr auto uri_character_class_unreserved = std::uint8_t{2};
+
+/*
+	The URI character classes of all byte values.
+*/
+inline constexpr auto uri_character_classes = [] {
+	auto classes = std::array<std::uint8_t, 256>{};
+	
+	auto const add_class = [&classes](std::string_view const characters, std::uint8_t const character_class) {
+		for (auto const character : characters) {
+			classes[static_cast<unsigned char>(character)] |= character_class;
+		}
+	};
+	constexpr auto unreserved_characters = std::string_view{
+		"0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ-._~"
+	};
+	add_class(unreserved_characters, uri_character_class_allowed | uri_character_class_unreserved);
+	add_class("%:/?#[]@!$&'()*+,;=", uri_character_class_allowed);
+
+	return classes;
+}();
+
 /*
 	Returns whether character is allowed in a URI-encoded string or not.
 */
 [[nodiscard]]
 constexpr bool get_is_allowed_uri_character(char const character) noexcept {
-	constexpr auto other_characters = std::string_view{"%-._~:/?#[]@!$&'()*+,;="};
+	return uri_character_classes[static_cast<unsigned char>(character)] & uri_character_class_allowed;
+}
+
+/*
+	Percent-encodes all characters in string that are not in character_class.
+	Runs of characters that do not need encoding are copied in bulk, and the result is allocated once.
+*/
+[[nodiscard]]
+inline std::string uri_encode_characters_not_in_class(
+	std::string_view const string, 
+	std::uint8_t const character_class, 
+	std::string_view const hex_digits
+) {
+	auto const get_is_kept = [character_class](char const character) {
+		return (uri_character_classes[static_cast<unsigned char>(character)] & character_class) != 0;
+	};
+	
+	auto const number_of_encoded_characters = static_cast<std::size_t>(
+		std::ranges::count_if(string, [&](char const character) { return !get_is_kept(character); })
+	);
+	if (number_of_encoded_characters == 0) {
+		return std::string{string};
+	}
 	
-	return (character >= '0' && character <= '9') || 
-		(character >= 'a' && character <= 'z') ||
-		(character >= 'A' && character <= 'Z') ||
-		other_characters.find(character) != std::string_view::npos;
+	auto result = std::string(string.size() + number_of_encoded_characters*2, '\0');
+	auto output = result.data();
+
+	for (auto position = string.begin(); position != string.end();) {
+		auto const run_end = std::find_if_not(position, string.end(), get_is_kept);
+		output = std::copy(position, run_end, output);
+		
+		for (position = run_end; position != string.end() && !get_is_kept(*position); ++position) {
+			auto const byte = static_cast<unsigned char>(*position);
+			*output++ = '%';
+			*output++ = hex_digits[byte >> 4];
+			*output++ = hex_digits[byte & 0xf];
+		}
+	}
+	return result;
 }
 
 /*
@@ -622,24 +1115,65 @@ constexpr bool get_is_allowed_uri_character(char const character) noexcept {
 */
 [[nodiscard]]
 inline std::string uri_encode(std::string_view const uri) {
-	auto result_string = std::string();
-	result_string.reserve(uri.size());
+	return uri_encode_characters_not_in_class(uri, uri_character_class_allowed, "0123456789abcdef");
+}
+
+/*
+	Returns the URI-encoded equivalent of a single URI component, for example a query parameter name or value.
+	Unlike uri_encode, this also encodes characters that have a special meaning in URIs, like '&', '=' and '/'.
+*/
+[[nodiscard]]
+inline std::string uri_encode_component(std::string_view const component) {
+	return uri_encode_characters_not_in_class(component, uri_character_class_unreserved, "0123456789ABCDEF");
+}
+
+/*
+	Returns the value of a hexadecimal digit, or -1 if character is not a hexadecimal digit.
+*/
+[[nodiscard]]
+constexpr int hex_digit_value(char const character) noexcept {
+	if (character >= '0' && character <= '9') {
+		return character - '0';
+	}
+	if (character >= 'a' && character <= 'f') {
+		return character - 'a' + 10;
+	}
+	if (character >= 'A' && character <= 'F') {
+		return character - 'A' + 10;
+	}
+	return -1;
+}
+
+/*
+	Returns the decoded equivalent of a URI-encoded string, replacing every "%xx" sequence with the byte it encodes.
+	'%' characters that are not followed by two hexadecimal digits are kept as they are.
+	'+' is not decoded to a space, since that is only done in form data.
+*/
+[[nodiscard]]
+inline std::string uri_decode(std::string_view const uri) {
+	auto result = std::string();
+	result.reserve(uri.size());
 
-	for (auto const character : uri) {
-		if (get_is_allowed_uri_character(character)) {
-			result_string += character;
+	for (auto position = std::size_t{};;) {
+		auto const percent_position = uri.find('%', position);
+		result.append(uri.substr(position, percent_position - position));
+		if (percent_position == std::string_view::npos) {
+			break;
 		}
-		else {
-			result_string += "%xx";
-			std::to_chars(
-				&result_string.back() - 1, 
-				&result_string.back() + 1, 
-				static_cast<unsigned char>(character), 
-				16
-			);
+		
+		if (percent_position + 2 < uri.size()) {
+			auto const high = hex_digit_value(uri[percent_position + 1]);
+			auto const low = hex_digit_value(uri[percent_position + 2]);
+			if (high >= 0 && low >= 0) {
+				result += static_cast<char>(high << 4 | low);
+				position = percent_position + 3;
+				continue;
+			}
 		}
+		result += '%';
+		position = percent_position + 1;
 	}
-	return result_string;
+	return result;
 }
 
 } // namespace utils
@@ -784,9 +1318,34 @@ public:
 		return {};
 	}
 
-	Socket() = delete;
-	~Socket(); // = default in .cpp
-
+	/*
+		Receives any available data from the socket into a buffer without consuming it.
+		The data stays in the socket and is returned again by the following 
+		peek_available, read and read_available calls. This function is nonblocking, 
+		and may return std::size_t{} if there was no data available. The function either 
+		returns the number of bytes that were peeked or a ConnectionClosed value if the peer 
+		closed the connection and there is no data left.
+	*/
+	[[nodiscard("The result is important as it contains the size that was actually peeked.")]]
+	std::variant<ConnectionClosed, std::size_t> peek_available(std::span<std::byte> buffer) const;
+	/*
+		Returns whether peek_available found that the peer closed the connection 
+		after the data that has been peeked, which is still returned by peek_available.
+	*/
+	[[nodiscard]]
+	bool get_is_closed_after_peeked_data() const noexcept;
+
+	/*
+		Blocks until there is data available to read from the socket, the peer closed 
+		the connection or the timeout expired. Returns false if the timeout expired.
+		Data that has already been peeked does not count as available.
+	*/
+	[[nodiscard]]
+	bool wait_for_data(std::chrono::milliseconds timeout) const;
+
+	Socket() = delete;
+	~Socket(); // = default in .cpp
+
 	Socket(Socket&&) noexcept; // = default in .cpp
 	Socket& operator=(Socket&&) noexcept; // = default in .cpp
  
@@ -858,6 +1417,74 @@ bool operator==(IsHeader auto const& lhs, IsHeader auto const& rhs) {
 	return lhs.value == rhs.value && utils::equal_ascii_case_insensitive(lhs.name, rhs.name);
 }
 
+/*
+	Header names that are common in responses, or that the library itself needs to look up.
+	A header with a known name can be found without any string comparisons.
+*/
+enum class KnownHeader : std::uint8_t {
+	AcceptRanges,
+	Age,
+	CacheControl,
+	Connection,
+	ContentDisposition,
+	ContentEncoding,
+	ContentLanguage,
+	ContentLength,
+	ContentLocation,
+	ContentRange,
+	ContentType,
+	Date,
+	ETag,
+	Expires,
+	KeepAlive,
+	LastModified,
+	Location,
+	RetryAfter,
+	Server,
+	SetCookie,
+	Trailer,
+	TransferEncoding,
+	Vary,
+	WwwAuthenticate,
+};
+
+inline constexpr auto known_header_count = static_cast<std::size_t>(KnownHeader::WwwAuthenticate) + 1;
+
+/*
+	Returns the name of a known header, for example "Content-Length" for KnownHeader::ContentLength.
+*/
+[[nodiscard]]
+constexpr std::string_view known_header_to_string(KnownHeader const header) noexcept {
+	using enum KnownHeader;
+	switch (header) {
+		case AcceptRanges:       return "Accept-Ranges";
+		case Age:                return "Age";
+		case CacheControl:       return "Cache-Control";
+		case Connection:         return "Connection";
+		case ContentDisposition: return "Content-Disposition";
+		case ContentEncoding:    return "Content-Encoding";
+		case ContentLanguage:    return "Content-Language";
+		case ContentLength:      return "Content-Length";
+		case ContentLocation:    return "Content-Location";
+		case ContentRange:       return "Content-Range";
+		case ContentType:        return "Content-Type";
+		case Date:               return "Date";
+		case ETag:               return "ETag";
+		case Expires:            return "Expires";
+		case KeepAlive:          return "Keep-Alive";
+		case LastModified:       return "Last-Modified";
+		case Location:           return "Location";
+		case RetryAfter:         return "Retry-After";
+		case Server:             return "Server";
+		case SetCookie:          return "Set-Cookie";
+		case Trailer:            return "Trailer";
+		case TransferEncoding:   return "Transfer-Encoding";
+		case Vary:               return "Vary";
+		case WwwAuthenticate:    return "WWW-Authenticate";
+	}
+	utils::unreachable();
+}
+
 enum class StatusCode {
 	Continue = 100,
 	SwitchingProtocols = 101,
@@ -931,9 +1558,9 @@ enum class StatusCode {
 };
 
 struct StatusLine {
-	std::string http_version;
+	std::pmr::string http_version;
 	StatusCode status_code = StatusCode::Unknown;
-	std::string status_message;
+	std::pmr::string status_message;
 
 	[[nodiscard]]
 	bool operator==(StatusLine const&) const noexcept = default;
@@ -941,9 +1568,40 @@ struct StatusLine {
 
 namespace algorithms {
 
+/*
+	Returns whether a status code is that of an interim response, which is followed by 
+	another response to the same request. These are the 1xx status codes except 101 Switching Protocols,
+	after which the connection no longer uses HTTP.
+*/
+[[nodiscard]]
+constexpr bool get_is_interim_status_code(StatusCode const status_code) noexcept {
+	return static_cast<int>(status_code) / 100 == 1 && status_code != StatusCode::SwitchingProtocols;
+}
+
+/*
+	Parses a status line like "HTTP/1.1 200 OK".
+	The strings of the result are allocated with allocator.
+*/
 [[nodiscard]]
-inline StatusLine parse_status_line(std::string_view const line) {
-	auto status_line = StatusLine{};
+inline StatusLine parse_status_line(std::string_view const line, std::pmr::polymorphic_allocator<> const allocator = {}) {
+	auto status_line = StatusLine{
+		.http_version = std::pmr::string(allocator), 
+		.status_message = std::pmr::string(allocator),
+	};
+
+	constexpr auto get_is_digit = [](char const character) { return character >= '0' && character <= '9'; };
+
+	// Fast path for the usual "HTTP/1.x NNN " prefix.
+	if (line.size() >= 13 && line.starts_with("HTTP/1.") && line[8] == ' ' && line[12] == ' ' && 
+		get_is_digit(line[9]) && get_is_digit(line[10]) && get_is_digit(line[11]))
+	{
+		status_line.http_version = line.substr(0, 8);
+		status_line.status_code = static_cast<StatusCode>((line[9] - '0')*100 + (line[10] - '0')*10 + (line[11] - '0'));
+		
+		auto const status_message = line.substr(13);
+		status_line.status_message = status_message.substr(0, status_message.find_last_not_of("\r\n ") + 1);
+		return status_line;
+	}
 
 	auto cursor = std::size_t{};
 	
@@ -1002,30 +1660,112 @@ constexpr std::optional<Header> parse_header(std::string_view const line) {
 	};
 }
 
+/*
+	Parses the header lines in headers, skipping lines that are not valid headers.
+	The result is allocated with allocator and points into headers.
+	A line that starts with whitespace continues the value of the header before it (obsolete line folding), 
+	in which case that value includes the line break. unfold_header_lines can replace the line breaks first.
+*/
 [[nodiscard]] 
-inline std::vector<Header> parse_headers_string(std::string_view const headers) 
+inline std::pmr::vector<Header> parse_headers_string(std::string_view const headers, std::pmr::polymorphic_allocator<> const allocator = {}) 
 {
-	auto result = std::vector<Header>();
+	auto result = std::pmr::vector<Header>(allocator);
+	// There is at most one header per line.
+	result.reserve(static_cast<std::size_t>(std::ranges::count(headers, '\n')) + 1);
 
-	std::ranges::copy(
-		headers 
-		| std::views::split('\n') | std::views::transform(utils::range_to_string_view)
-		| std::views::transform(parse_header) | utils::filter_true | utils::dereference_move,
-		std::back_inserter(result)
-	);
+	// Whether the last line was a header, which a folded line can continue.
+	auto is_after_header = false;
+
+	for (auto line_start = std::size_t{}; line_start < headers.size();) {
+		auto const line_end = std::min(headers.find('\n', line_start), headers.size());
+		auto const line = headers.substr(line_start, line_end - line_start);
+		line_start = line_end + 1;
+
+		if (line.starts_with(' ') || line.starts_with('\t')) {
+			if (auto const value_end = line.find_last_not_of(" \t\r"); 
+				is_after_header && value_end != std::string_view::npos) 
+			{
+				auto& value = result.back().value;
+				value = std::string_view{value.data(), static_cast<std::size_t>(line.data() + value_end + 1 - value.data())};
+			}
+			continue;
+		}
+
+		if (auto const header = parse_header(line)) {
+			result.push_back(*header);
+			is_after_header = true;
+		}
+		else {
+			is_after_header = false;
+		}
+	}
 
 	return result;
 }
 
+/*
+	Returns the value of the first header in headers with the given name, without parsing the other headers.
+	headers should not contain folded lines (see unfold_header_lines).
+*/
+[[nodiscard]]
+constexpr std::optional<std::string_view> find_header_value_in_string(std::string_view const headers, std::string_view const name) {
+	for (auto line_start = std::size_t{}; line_start < headers.size();) {
+		auto const line_end = std::min(headers.find('\n', line_start), headers.size());
+		auto const line = headers.substr(line_start, line_end - line_start);
+		line_start = line_end + 1;
+		
+		if (line.size() > name.size() && line[name.size()] == ':' && 
+			utils::equal_ascii_case_insensitive(line.substr(0, name.size()), name))
+		{
+			if (auto const header = parse_header(line)) {
+				return header->value;
+			}
+		}
+	}
+	return {};
+}
+
+/*
+	Removes the lines of all headers with the given name from a string of header lines.
+*/
+template<typename String_>
+constexpr void remove_header_lines_from_string(String_& headers, std::string_view const name) {
+	for (auto line_start = std::size_t{}; line_start < headers.size();) {
+		auto const line_end = std::min(headers.find('\n', line_start), headers.size() - 1) + 1;
+		auto const line = std::string_view{headers}.substr(line_start, line_end - line_start);
+		
+		if (line.size() > name.size() && line[name.size()] == ':' && 
+			utils::equal_ascii_case_insensitive(line.substr(0, name.size()), name))
+		{
+			headers.erase(line_start, line_end - line_start);
+		}
+		else line_start = line_end;
+	}
+}
+
+/*
+	Replaces the line breaks of folded header lines with spaces, as allowed by RFC 9112, 
+	so that a folded header value becomes a single line.
+*/
+inline void unfold_header_lines(std::span<char> const headers) noexcept {
+	auto const headers_string = std::string_view{headers.data(), headers.size()};
+
+	for (auto position = headers_string.find('\n'); position != std::string_view::npos; position = headers_string.find('\n', position + 1)) {
+		if (position + 1 < headers.size() && (headers[position + 1] == ' ' || headers[position + 1] == '\t')) {
+			headers[position] = ' ';
+			if (position > 0 && headers[position - 1] == '\r') {
+				headers[position - 1] = ' ';
+			}
+		}
+	}
+}
+
 template<std::ranges::input_range Range_, IsHeader Header_ = std::ranges::range_value_t<Range_>>
 [[nodiscard]]
 inline Header_ const* find_header_by_name(Range_ const& headers, std::string_view const name) 
 {
-	auto const lowercase_name_to_search = utils::range_to_string(
-		name | utils::ascii_lowercase_transform
-	);
-	auto const pos = std::ranges::find_if(headers, [&](Header_ const& header) {
-		return std::ranges::equal(lowercase_name_to_search, header.name | utils::ascii_lowercase_transform);
+	auto const pos = std::ranges::find_if(headers, [name](Header_ const& header) {
+		return utils::equal_ascii_case_insensitive(header.name, name);
 	});
 	if (pos == std::ranges::end(headers)) {
 		return nullptr;
@@ -1035,142 +1775,721 @@ inline Header_ const* find_header_by_name(Range_ const& headers, std::string_vie
 	}
 }
 
-struct ParsedResponse {
-	StatusLine status_line;
-	std::string headers_string;
-	std::vector<Header> headers; // Points into headers_string
-	utils::DataVector body_data;
-
-	[[nodiscard]]
-	bool operator==(ParsedResponse const&) const noexcept = default;
+/*
+	Returns whether a Transfer-Encoding header value means that the body is chunked,
+	which is the case when "chunked" is the last transfer coding in the list.
+	For example, "chunked" and "gzip, Chunked" return true, while "gzip" returns false.
+*/
+[[nodiscard]]
+constexpr bool get_is_chunked_transfer_encoding(std::string_view const transfer_encoding) noexcept {
+	constexpr auto whitespace_characters = std::string_view{" \t"};
+	
+	auto const comma_position = transfer_encoding.rfind(',');
+	auto last_coding = comma_position == std::string_view::npos ? 
+		transfer_encoding : transfer_encoding.substr(comma_position + 1);
+	
+	auto const start = last_coding.find_first_not_of(whitespace_characters);
+	if (start == std::string_view::npos) {
+		return false;
+	}
+	last_coding = last_coding.substr(start, last_coding.find_last_not_of(whitespace_characters) + 1 - start);
 
-	ParsedResponse() = default;
-	ParsedResponse(StatusLine p_status_line, std::string p_headers_string = {}, std::vector<Header> p_headers = {}, utils::DataVector p_body_data = {}) :
-		status_line{std::move(p_status_line)},
-		headers_string(std::move(p_headers_string)),
-		headers(std::move(p_headers)),
-		body_data(std::move(p_body_data))
-	{}
+	return utils::equal_ascii_case_insensitive(last_coding, "chunked");
+}
 
-	ParsedResponse(ParsedResponse&&) = default;
-	ParsedResponse& operator=(ParsedResponse&&) = default;
+/*
+	A chunk extension of a body with the chunked transfer encoding, for example name=value in "1A;name=value".
+	value is empty if the extension has no value. The quotes around a quoted value are removed, 
+	but any backslash escapes inside it are kept.
+*/
+struct ChunkExtension {
+	std::string_view name, value;
 
-	ParsedResponse(ParsedResponse const&) = delete;
-	ParsedResponse& operator=(ParsedResponse const&) = delete;
+	[[nodiscard]]
+	bool operator==(ChunkExtension const&) const = default;
 };
 
-struct ParsedHeadersInterface {
-	virtual ~ParsedHeadersInterface() = default;
-	
-	constexpr virtual ParsedResponse const& get_parsed_response() const noexcept = 0;
+/*
+	Parses a list of chunk extensions, for example ";name=value;flag;quoted=\"a;b\"".
+	Extensions without a name are skipped.
+	The result is allocated with allocator and points into extensions.
+*/
+[[nodiscard]]
+inline std::pmr::vector<ChunkExtension> parse_chunk_extensions(std::string_view const extensions, std::pmr::polymorphic_allocator<> const allocator = {}) {
+	constexpr auto trim_whitespace = [](std::string_view const string) {
+		constexpr auto whitespace_characters = std::string_view{" \t"};
+		auto const start = string.find_first_not_of(whitespace_characters);
+		if (start == std::string_view::npos) {
+			return std::string_view{};
+		}
+		return string.substr(start, string.find_last_not_of(whitespace_characters) + 1 - start);
+	};
 
-	/*
-		Returns the status code from the response header.
-	*/
-	[[nodiscard]]
-	StatusCode get_status_code() const {
-		return get_parsed_response().status_line.status_code;
+	auto result = std::pmr::vector<ChunkExtension>(allocator);
+
+	for (auto position = std::size_t{}; position < extensions.size();) {
+		// Semicolons in quoted values do not end the extension.
+		auto end = position;
+		for (auto is_quoted = false; end < extensions.size() && (is_quoted || extensions[end] != ';'); ++end) {
+			if (extensions[end] == '"') {
+				is_quoted = !is_quoted;
+			}
+			else if (is_quoted && extensions[end] == '\\') {
+				++end;
+			}
+		}
+		auto const extension = extensions.substr(position, end - position);
+		position = end + 1;
+
+		auto const equals_position = extension.find('=');
+		auto const name = trim_whitespace(extension.substr(0, equals_position));
+		if (name.empty()) {
+			continue;
+		}
+		auto value = equals_position == std::string_view::npos ? std::string_view{} : trim_whitespace(extension.substr(equals_position + 1));
+		if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+			value = value.substr(1, value.size() - 2);
+		}
+		result.push_back(ChunkExtension{.name = name, .value = value});
 	}
-	/*
-		Returns the status code description from the response header.
-	*/
+
+	return result;
+}
+
+/*
+	A range of bytes in a resource, as used by the Range and Content-Range headers.
+	The positions are inclusive. If last is not set, the range extends to the end of the resource.
+*/
+struct ByteRange {
+	std::uint64_t first{};
+	std::optional<std::uint64_t> last;
+
 	[[nodiscard]]
-	std::string_view get_status_message() const {
-		return get_parsed_response().status_line.status_message;
+	bool operator==(ByteRange const&) const noexcept = default;
+};
+
+/*
+	Returns the value of a Range header that requests a single byte range, for example "bytes=0-499".
+*/
+[[nodiscard]]
+inline std::string byte_range_to_range_header_value(ByteRange const range) {
+	if (range.last) {
+		return std::format("bytes={}-{}", range.first, *range.last);
 	}
+	return std::format("bytes={}-", range.first);
+}
+
+/*
+	The parsed value of a Content-Range header.
+*/
+struct ContentRange {
 	/*
-		Returns the HTTP version from the response header.
+		This is not set for unsatisfied ranges, where the range is an asterisk. 
+		Those are sent with 416 (Range Not Satisfiable) responses. Otherwise, last is always set.
 	*/
-	[[nodiscard]]
-	std::string_view get_http_version() const {
-		return get_parsed_response().status_line.http_version;
-	}
+	std::optional<ByteRange> range;
 	/*
-		Returns a const reference to the parsed status line object.
+		This is not set if the server does not know the complete length of the resource.
 	*/
+	std::optional<std::uint64_t> complete_length;
+
 	[[nodiscard]]
-	StatusLine const& get_status_line() const {
-		return get_parsed_response().status_line;
+	bool operator==(ContentRange const&) const noexcept = default;
+};
+
+/*
+	Parses the value of a Content-Range header, for example "bytes 0-499/1234".
+	Only byte ranges are supported.
+*/
+[[nodiscard]]
+inline std::optional<ContentRange> parse_content_range(std::string_view const value) {
+	constexpr auto unit_prefix = std::string_view{"bytes "};
+	if (value.size() < unit_prefix.size() || !utils::equal_ascii_case_insensitive(value.substr(0, unit_prefix.size()), unit_prefix)) {
+		return {};
 	}
 
-	/*
-		Returns the headers of the response as a string.
-		The returned string_view shall not outlive this Response object.
-	*/
-	[[nodiscard]] 
-	std::string_view get_headers_string() const {
-		return get_parsed_response().headers_string;
+	auto const slash_position = value.find('/', unit_prefix.size());
+	if (slash_position == std::string_view::npos) {
+		return {};
 	}
 
-	/*
-		Returns the headers of the response as Header objects.
-		The returned span shall not outlive this Response object.
-	*/
-	[[nodiscard]] 
-	std::span<Header const> get_headers() const {
-		return get_parsed_response().headers;
+	auto result = ContentRange{};
+
+	if (auto const range_string = value.substr(unit_prefix.size(), slash_position - unit_prefix.size()); 
+		range_string != "*")
+	{
+		auto const dash_position = range_string.find('-');
+		if (dash_position == std::string_view::npos) {
+			return {};
+		}
+		auto const first = utils::string_to_integral<std::uint64_t>(range_string.substr(0, dash_position));
+		auto const last = utils::string_to_integral<std::uint64_t>(range_string.substr(dash_position + 1));
+		if (!first || !last || *last < *first) {
+			return {};
+		}
+		result.range = ByteRange{.first = *first, .last = *last};
 	}
-	/*
-		Returns a header of the response by its name.
-		The returned header shall not outlive this Response object.
-	*/	
-	[[nodiscard]] 
-	std::optional<Header> get_header(std::string_view const name) const {
-		if (auto const header = algorithms::find_header_by_name(get_parsed_response().headers, name)) {
-			return *header;
+
+	if (auto const length_string = value.substr(slash_position + 1); length_string != "*") 
+	{
+		if (auto const complete_length = utils::string_to_integral<std::uint64_t>(length_string)) {
+			result.complete_length = *complete_length;
 		}
 		else return {};
 	}
+	else if (!result.range) {
+		return {};
+	}
+
+	return result;
+}
+
+/*
+	A perfect hash table of the known header names, which is created at compile time.
+	The seed of the hash function is chosen so that no two known header names share a slot.
+*/
+class KnownHeaderTable {
+public:
 	/*
-		Returns a header value of the response by its name.
-		The returned std::string_view shall not outlive this Response object.
+		Returns the known header with the case-insensitive name, if there is one.
 	*/
-	[[nodiscard]] 
-	std::optional<std::string_view> get_header_value(std::string_view const name) const {
-		if (auto const header = algorithms::find_header_by_name(get_parsed_response().headers, name)) {
-			return header->value;
+	[[nodiscard]]
+	constexpr std::optional<KnownHeader> find(std::string_view const name) const noexcept {
+		auto const header = slots_[get_slot_(name, seed_)];
+		if (header && utils::equal_ascii_case_insensitive(known_header_to_string(*header), name)) {
+			return header;
 		}
-		else return {};
+		return {};
 	}
-};
 
-class ResponseParser;
+	consteval KnownHeaderTable() {
+		for (;; ++seed_) {
+			slots_ = {};
+			auto const has_collision = [this] {
+				for (auto i = std::size_t{}; i < known_header_count; ++i) {
+					auto& slot = slots_[get_slot_(known_header_to_string(static_cast<KnownHeader>(i)), seed_)];
+					if (slot) {
+						return true;
+					}
+					slot = static_cast<KnownHeader>(i);
+				}
+				return false;
+			}();
+			if (!has_collision) {
+				return;
+			}
+		}
+	}
 
-} // namespace algorithms
+private:
+	static constexpr auto size_ = std::size_t{64};
 
-class ResponseProgressRaw {	
-	friend class algorithms::ResponseParser;
-	
-public:
-	constexpr void stop() noexcept {
-		is_stopped_ = true;
+	[[nodiscard]]
+	static constexpr std::size_t get_slot_(std::string_view const name, std::uint32_t const seed) noexcept {
+		return utils::hash_ascii_case_insensitive(name, seed) % size_;
 	}
 
-	std::span<std::byte const> data;
-	std::size_t new_data_start;
+	std::uint32_t seed_{1};
+	std::array<std::optional<KnownHeader>, size_> slots_{};
+};
 
-	explicit constexpr ResponseProgressRaw(std::span<std::byte const> const p_data, std::size_t const p_new_data_start) noexcept :
-		data{p_data}, new_data_start{p_new_data_start}
-	{}
+inline constexpr auto known_header_table = KnownHeaderTable{};
 
-private:
-	bool is_stopped_{false};
-};
+/*
+	Returns the known header with the case-insensitive name, if there is one.
+*/
+[[nodiscard]]
+constexpr std::optional<KnownHeader> find_known_header(std::string_view const name) noexcept {
+	return known_header_table.find(name);
+}
 
-class ResponseProgressHeaders : public algorithms::ParsedHeadersInterface {
+/*
+	A hash table from case-insensitive header names to positions in a list of headers,
+	so that headers can be found by name without comparing the name to every header.
+	It stores positions instead of pointers, so it stays valid when the list of headers is moved.
+*/
+class HeaderIndex {
 public:
-	ResponseProgressRaw raw_progress;
-
-	constexpr void stop() noexcept {
-		raw_progress.stop();
+	/*
+		Returns the first header in headers with the given name, or nullptr if there is none.
+		headers must be the same headers that the index was created from.
+	*/
+	[[nodiscard]]
+	Header const* find(std::span<Header const> const headers, std::string_view const name) const noexcept {
+		if (slots_.empty()) {
+			// There are no headers, or too many to be indexed.
+			return find_header_by_name(headers, name);
+		}
+		
+		auto const mask = slots_.size() - 1;
+		for (auto slot = hash_(name) & mask;; slot = (slot + 1) & mask) {
+			if (slots_[slot] == 0) {
+				return nullptr;
+			}
+			if (auto const& header = headers[slots_[slot] - 1u]; 
+				utils::equal_ascii_case_insensitive(header.name, name)) 
+			{
+				return &header;
+			}
+		}
 	}
-	
+
+	/*
+		Returns the first header in headers with a known name, or nullptr if there is none.
+		headers must be the same headers that the index was created from.
+	*/
 	[[nodiscard]]
-	constexpr algorithms::ParsedResponse const& get_parsed_response() const noexcept override {
-		return parsed_response_;
+	Header const* find(std::span<Header const> const headers, KnownHeader const name) const noexcept {
+		if (slots_.empty()) {
+			return find_header_by_name(headers, known_header_to_string(name));
+		}
+		if (auto const slot = known_header_slots_[static_cast<std::size_t>(name)]) {
+			return &headers[slot - 1u];
+		}
+		return nullptr;
 	}
 
-	ResponseProgressHeaders(ResponseProgressRaw const p_raw_progress, algorithms::ParsedResponse const& parsed_response) :
+	[[nodiscard]]
+	bool operator==(HeaderIndex const&) const noexcept = default;
+
+	[[nodiscard]]
+	std::pmr::polymorphic_allocator<> get_allocator() const noexcept {
+		return slots_.get_allocator();
+	}
+
+	HeaderIndex() = default;
+	explicit HeaderIndex(std::pmr::polymorphic_allocator<> const allocator) :
+		slots_(allocator)
+	{}
+	explicit HeaderIndex(std::span<Header const> const headers, std::pmr::polymorphic_allocator<> const allocator = {}) :
+		slots_(allocator)
+	{
+		if (headers.empty() || headers.size() >= std::numeric_limits<Slot>::max()) {
+			return;
+		}
+
+		// The table is at most half full, which keeps the probe sequences short.
+		slots_.resize(std::bit_ceil(std::max(headers.size()*2, std::size_t{8})));
+		auto const mask = slots_.size() - 1;
+
+		for (auto i = std::size_t{}; i < headers.size(); ++i) {
+			if (auto const known_header = find_known_header(headers[i].name)) {
+				if (auto& slot = known_header_slots_[static_cast<std::size_t>(*known_header)]; slot == 0) {
+					slot = static_cast<Slot>(i + 1);
+				}
+			}
+			for (auto slot = hash_(headers[i].name) & mask;; slot = (slot + 1) & mask) {
+				if (slots_[slot] == 0) {
+					slots_[slot] = static_cast<Slot>(i + 1);
+					break;
+				}
+				// Only the first header with a name is found by name.
+				if (utils::equal_ascii_case_insensitive(headers[slots_[slot] - 1u].name, headers[i].name)) {
+					break;
+				}
+			}
+		}
+	}
+
+private:
+	// The position of a header plus one, or 0 for an empty slot.
+	using Slot = std::uint16_t;
+
+	[[nodiscard]]
+	static std::size_t hash_(std::string_view const name) noexcept {
+		return utils::hash_ascii_case_insensitive(name);
+	}
+
+	std::pmr::vector<Slot> slots_;
+	// The positions of the first headers with known names, indexed by KnownHeader.
+	std::array<Slot, known_header_count> known_header_slots_{};
+};
+
+class ResponseParser;
+
+/*
+	The parts of a parsed response.
+	When it is created with a memory resource, the status line, headers string, headers and 
+	header index are allocated from an arena that is a single allocation from the memory resource, 
+	and that is freed all at once with the response. The body is allocated from the memory resource itself.
+*/
+struct ParsedResponse {
+	friend class ResponseParser;
+
+private:
+	/*
+		A monotonic buffer resource whose first buffer is part of the arena itself, 
+		so that the metadata of most responses needs no allocations besides the arena.
+	*/
+	class Arena_ {
+	public:
+		[[nodiscard]]
+		std::pmr::memory_resource* get_resource() noexcept {
+			return &resource_;
+		}
+
+		explicit Arena_(std::pmr::memory_resource* const upstream) :
+			resource_{buffer_.data(), buffer_.size(), upstream}
+		{}
+
+		Arena_(Arena_ const&) = delete;
+		Arena_& operator=(Arena_ const&) = delete;
+
+	private:
+		std::array<std::byte, 4096> buffer_;
+		std::pmr::monotonic_buffer_resource resource_;
+	};
+	struct ArenaDeleter_ {
+		std::pmr::memory_resource* upstream;
+
+		void operator()(Arena_* const arena) const {
+			std::pmr::polymorphic_allocator<>{upstream}.delete_object(arena);
+		}
+	};
+
+	// This is declared first so that it is destroyed after the data members that are allocated from it.
+	std::unique_ptr<Arena_, ArenaDeleter_> arena_;
+
+public:
+	StatusLine status_line;
+	std::pmr::string headers_string;
+	utils::pmr::DataVector body_data;
+	/*
+		The body, if it is stored in segments instead of in body_data.
+		See ResponseParsingOptions::body_segment_size.
+	*/
+	utils::SegmentedData body_segments;
+	/*
+		The size of the body after any content decoding. 
+		This is only different from body_data.size() if the body was passed to a body sink or is stored in segments.
+	*/
+	std::size_t body_size{};
+	/*
+		The size of the body as it was sent by the server, before any content decoding.
+		This excludes the framing of chunked transfer encoding.
+	*/
+	std::size_t encoded_body_size{};
+	/*
+		The trailer section of a body with the chunked transfer encoding, 
+		which has the same format as the header lines in headers_string.
+	*/
+	std::pmr::string trailers_string;
+	/*
+		The chunk extensions of all chunks of a body with the chunked transfer encoding, 
+		in the order that they were received. See parse_chunk_extensions.
+	*/
+	std::pmr::string chunk_extensions_string;
+
+	/*
+		Headers that are parsed lazily are parsed before they are compared.
+	*/
+	[[nodiscard]]
+	bool operator==(ParsedResponse const& other) const {
+		parse_pending_headers_();
+		other.parse_pending_headers_();
+		return status_line == other.status_line && headers_string == other.headers_string && 
+			headers_ == other.headers_ && header_index_ == other.header_index_ && body_data == other.body_data &&
+			body_segments == other.body_segments &&
+			body_size == other.body_size && encoded_body_size == other.encoded_body_size &&
+			trailers_string == other.trailers_string && chunk_extensions_string == other.chunk_extensions_string;
+	}
+
+	ParsedResponse() = default;
+	/*
+		Allocates the metadata of the response from an arena that is allocated from memory_resource,
+		and the body from memory_resource.
+	*/
+	explicit ParsedResponse(std::pmr::memory_resource* const memory_resource) :
+		arena_{std::pmr::polymorphic_allocator<>{memory_resource}.new_object<Arena_>(memory_resource), ArenaDeleter_{memory_resource}},
+		status_line{
+			.http_version = std::pmr::string(arena_->get_resource()), 
+			.status_message = std::pmr::string(arena_->get_resource()),
+		},
+		headers_string(arena_->get_resource()),
+		body_data(memory_resource),
+		body_segments{memory_resource},
+		trailers_string(arena_->get_resource()),
+		chunk_extensions_string(arena_->get_resource()),
+		headers_(arena_->get_resource()),
+		header_index_{arena_->get_resource()}
+	{}
+	ParsedResponse(
+		StatusLine p_status_line, 
+		std::string_view const p_headers_string = {}, 
+		std::vector<Header> const& p_headers = {}, 
+		std::span<std::byte const> const p_body_data = {}
+	) :
+		status_line{std::move(p_status_line)},
+		headers_string(p_headers_string),
+		body_data(p_body_data.begin(), p_body_data.end()),
+		body_size{body_data.size()},
+		encoded_body_size{body_data.size()},
+		headers_(p_headers.begin(), p_headers.end()),
+		header_index_{headers_}
+	{}
+
+	/*
+		Returns the headers, which are parsed first if they are parsed lazily and have not been accessed yet.
+		This can be called from several threads at once, in which case the headers are only parsed by one of them.
+	*/
+	[[nodiscard]]
+	std::span<Header const> get_headers() const {
+		parse_pending_headers_();
+		return headers_;
+	}
+	/*
+		Returns the first header with the given name, or nullptr if there is none.
+		See get_headers.
+	*/
+	[[nodiscard]]
+	Header const* find_header(std::string_view const name) const {
+		parse_pending_headers_();
+		return header_index_.find(headers_, name);
+	}
+	[[nodiscard]]
+	Header const* find_header(KnownHeader const name) const {
+		parse_pending_headers_();
+		return header_index_.find(headers_, name);
+	}
+
+	ParsedResponse(ParsedResponse&&) noexcept = default;
+	ParsedResponse& operator=(ParsedResponse&& other) noexcept {
+		// The data members may be allocated from arena_, so they can not be assigned separately
+		// without the memory of the old data members outliving their arena.
+		if (this != &other) {
+			std::destroy_at(this);
+			std::construct_at(this, std::move(other));
+		}
+		return *this;
+	}
+
+	ParsedResponse(ParsedResponse const&) = delete;
+	ParsedResponse& operator=(ParsedResponse const&) = delete;
+
+private:
+	[[nodiscard]]
+	std::string_view get_header_lines_() const noexcept {
+		auto const status_line_end = headers_string.find_first_of("\r\n");
+		return status_line_end == std::string::npos ? std::string_view{} : std::string_view{headers_string}.substr(status_line_end);
+	}
+	/*
+		Returns the value of a header that is needed before the headers have been accessed, 
+		without parsing all headers if they are parsed lazily.
+	*/
+	[[nodiscard]]
+	std::optional<std::string_view> find_header_value_without_parsing_(KnownHeader const name) const {
+		// This is only called by the parser, before the response can be accessed from other threads.
+		if (headers_state_.value.load(std::memory_order_relaxed) != HeadersState_::Parsed) {
+			return find_header_value_in_string(get_header_lines_(), known_header_to_string(name));
+		}
+		if (auto const header = header_index_.find(headers_, name)) {
+			return header->value;
+		}
+		return {};
+	}
+	void parse_headers_() const {
+		headers_ = parse_headers_string(get_header_lines_(), headers_.get_allocator());
+		header_index_ = HeaderIndex{headers_, header_index_.get_allocator()};
+	}
+	void set_headers_pending_() noexcept {
+		headers_state_.value.store(HeadersState_::Pending, std::memory_order_relaxed);
+	}
+	/*
+		Parses the headers if they are parsed lazily and have not been parsed yet.
+		If several threads get here at once, one of them parses the headers and the others wait for it.
+	*/
+	void parse_pending_headers_() const {
+		auto state = headers_state_.value.load(std::memory_order_acquire);
+		while (state != HeadersState_::Parsed) {
+			if (state == HeadersState_::Parsing) {
+				headers_state_.value.wait(state, std::memory_order_acquire);
+				state = headers_state_.value.load(std::memory_order_acquire);
+			}
+			else if (headers_state_.value.compare_exchange_weak(state, HeadersState_::Parsing, std::memory_order_acquire)) {
+				// If parsing fails, the headers are left pending so that the next access tries again.
+				auto new_state = HeadersState_::Pending;
+				auto const publish_state = utils::Cleanup{[&] {
+					headers_state_.value.store(new_state, std::memory_order_release);
+					headers_state_.value.notify_all();
+				}};
+				parse_headers_();
+				new_state = HeadersState_::Parsed;
+				return;
+			}
+		}
+	}
+
+	// These point into headers_string. 
+	// They are mutable because headers that are parsed lazily are parsed when they are first accessed.
+	mutable std::pmr::vector<Header> headers_;
+	mutable HeaderIndex header_index_; // Must be recreated when headers_ changes
+
+	enum class HeadersState_ : std::uint8_t {
+		Parsed,
+		// The headers in headers_string are parsed lazily and have not been parsed yet.
+		Pending,
+		// The headers are being parsed by one thread, and other threads wait for it.
+		Parsing,
+	};
+	// std::atomic is not movable, but a response is only moved by the thread that owns it.
+	struct AtomicHeadersState_ {
+		std::atomic<HeadersState_> value{HeadersState_::Parsed};
+
+		AtomicHeadersState_() = default;
+		AtomicHeadersState_(AtomicHeadersState_&& other) noexcept :
+			value{other.value.load(std::memory_order_relaxed)}
+		{}
+		AtomicHeadersState_& operator=(AtomicHeadersState_&& other) noexcept {
+			value.store(other.value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			return *this;
+		}
+	};
+	mutable AtomicHeadersState_ headers_state_;
+};
+
+struct ParsedHeadersInterface {
+	virtual ~ParsedHeadersInterface() = default;
+	
+	constexpr virtual ParsedResponse const& get_parsed_response() const noexcept = 0;
+
+	/*
+		Returns the status code from the response header.
+	*/
+	[[nodiscard]]
+	StatusCode get_status_code() const {
+		return get_parsed_response().status_line.status_code;
+	}
+	/*
+		Returns the status code description from the response header.
+	*/
+	[[nodiscard]]
+	std::string_view get_status_message() const {
+		return get_parsed_response().status_line.status_message;
+	}
+	/*
+		Returns the HTTP version from the response header.
+	*/
+	[[nodiscard]]
+	std::string_view get_http_version() const {
+		return get_parsed_response().status_line.http_version;
+	}
+	/*
+		Returns a const reference to the parsed status line object.
+	*/
+	[[nodiscard]]
+	StatusLine const& get_status_line() const {
+		return get_parsed_response().status_line;
+	}
+
+	/*
+		Returns the headers of the response as a string.
+		The returned string_view shall not outlive this Response object.
+	*/
+	[[nodiscard]] 
+	std::string_view get_headers_string() const {
+		return get_parsed_response().headers_string;
+	}
+
+	/*
+		Returns the headers of the response as Header objects.
+		The returned span shall not outlive this Response object.
+	*/
+	[[nodiscard]] 
+	std::span<Header const> get_headers() const {
+		return get_parsed_response().get_headers();
+	}
+	/*
+		Returns a header of the response by its name.
+		The returned header shall not outlive this Response object.
+	*/	
+	[[nodiscard]] 
+	std::optional<Header> get_header(std::string_view const name) const {
+		if (auto const header = get_parsed_response().find_header(name)) {
+			return *header;
+		}
+		else return {};
+	}
+	/*
+		Returns a header of the response by its name, without comparing any strings.
+		The returned header shall not outlive this Response object.
+	*/	
+	[[nodiscard]] 
+	std::optional<Header> get_header(KnownHeader const name) const {
+		if (auto const header = get_parsed_response().find_header(name)) {
+			return *header;
+		}
+		else return {};
+	}
+	/*
+		Returns a header value of the response by its name.
+		The returned std::string_view shall not outlive this Response object.
+	*/
+	[[nodiscard]] 
+	std::optional<std::string_view> get_header_value(std::string_view const name) const {
+		if (auto const header = get_parsed_response().find_header(name)) {
+			return header->value;
+		}
+		else return {};
+	}
+	/*
+		Returns a header value of the response by its name, without comparing any strings.
+		The returned std::string_view shall not outlive this Response object.
+	*/
+	[[nodiscard]] 
+	std::optional<std::string_view> get_header_value(KnownHeader const name) const {
+		if (auto const header = get_parsed_response().find_header(name)) {
+			return header->value;
+		}
+		else return {};
+	}
+	/*
+		Returns the parsed Content-Range header of the response, which is sent 
+		with 206 (Partial Content) and 416 (Range Not Satisfiable) responses.
+	*/
+	[[nodiscard]]
+	std::optional<ContentRange> get_content_range() const {
+		if (auto const value = get_header_value(KnownHeader::ContentRange)) {
+			return parse_content_range(*value);
+		}
+		else return {};
+	}
+};
+
+} // namespace algorithms
+
+class ResponseProgressRaw {	
+	friend class algorithms::ResponseParser;
+	
+public:
+	constexpr void stop() noexcept {
+		is_stopped_ = true;
+	}
+
+	std::span<std::byte const> data;
+	std::size_t new_data_start;
+
+	explicit constexpr ResponseProgressRaw(std::span<std::byte const> const p_data, std::size_t const p_new_data_start) noexcept :
+		data{p_data}, new_data_start{p_new_data_start}
+	{}
+
+private:
+	bool is_stopped_{false};
+};
+
+class ResponseProgressHeaders : public algorithms::ParsedHeadersInterface {
+public:
+	ResponseProgressRaw raw_progress;
+
+	constexpr void stop() noexcept {
+		raw_progress.stop();
+	}
+	
+	[[nodiscard]]
+	constexpr algorithms::ParsedResponse const& get_parsed_response() const noexcept override {
+		return parsed_response_;
+	}
+
+	ResponseProgressHeaders(ResponseProgressRaw const p_raw_progress, algorithms::ParsedResponse const& parsed_response) :
 		raw_progress{p_raw_progress}, parsed_response_{parsed_response}
 	{}
 
@@ -1191,9 +2510,25 @@ class ResponseProgressBody : public algorithms::ParsedHeadersInterface {
 public:
 	ResponseProgressRaw raw_progress;
 
+	/*
+		This is empty if the body is passed to a body sink, 
+		because then the body data is not kept after it has been consumed.
+		It is also empty if the body is stored in segments, see ResponseParsingOptions::body_segment_size.
+	*/
 	std::span<std::byte const> body_data_so_far;
 	/*
-		This may not have a value if the transfer encoding is chunked, in which
+		The number of body bytes that have been received so far, after any content decoding.
+		Unlike body_data_so_far, this is also available when a body sink is used.
+	*/
+	std::size_t body_size_so_far;
+	/*
+		The number of body bytes that have been received so far, before any content decoding.
+		This is the same as body_size_so_far if the body is not content encoded.
+	*/
+	std::size_t encoded_body_size_so_far;
+	/*
+		This is the expected value of encoded_body_size_so_far when the whole body has been received.
+		It may not have a value if the transfer encoding is chunked, in which
 		case the full body length is not known ahead of time.
 	*/
 	std::optional<std::size_t> total_expected_body_size;
@@ -1211,10 +2546,14 @@ public:
 		ResponseProgressRaw const p_raw_progress, 
 		algorithms::ParsedResponse const& parsed_response,
 		std::span<std::byte const> const p_body_data_so_far, 
+		std::size_t const p_body_size_so_far,
+		std::size_t const p_encoded_body_size_so_far,
 		std::optional<std::size_t> const p_total_expected_body_size
 	) : 
 		raw_progress{p_raw_progress},
 		body_data_so_far{p_body_data_so_far},
+		body_size_so_far{p_body_size_so_far},
+		encoded_body_size_so_far{p_encoded_body_size_so_far},
 		total_expected_body_size{p_total_expected_body_size},
 		parsed_response_{parsed_response}
 	{}
@@ -1245,11 +2584,33 @@ public:
 	/*
 		Returns the body of the response.
 		The returned std::span shall not outlive this Response object.
+		If the body was passed to a body sink, it is empty.
 	*/
 	[[nodiscard]]
 	std::span<std::byte const> get_body() const {
 		return parsed_response_.body_data;
 	}
+	/*
+		Returns the body of the response as a range of std::span<std::byte const>, 
+		if it was stored in segments (see Request::enable_segmented_body).
+		Otherwise, the range is empty and the body is returned by get_body.
+		The returned range shall not outlive this Response object.
+	*/
+	[[nodiscard]]
+	auto get_body_segments() const {
+		return parsed_response_.body_segments.get_segments();
+	}
+	/*
+		Moves a body that is stored in segments into one contiguous buffer, 
+		so that it is returned by get_body and get_body_string.
+		This copies the body once. If the body is not stored in segments, nothing is done.
+	*/
+	void flatten_body() {
+		if (!parsed_response_.body_segments.empty()) {
+			parsed_response_.body_data = parsed_response_.body_segments.flatten(parsed_response_.body_data.get_allocator());
+			parsed_response_.body_segments.clear();
+		}
+	}
 	/*
 		Returns the body of the response as a string.
 		The returned std::string_view shall not outlive this Response object.
@@ -1258,10 +2619,52 @@ public:
 	std::string_view get_body_string() const {
 		return utils::data_to_string(get_body());
 	}
+	/*
+		Returns the size of the body after any content decoding.
+		This is also available if the body was passed to a body sink.
+	*/
+	[[nodiscard]]
+	std::size_t get_body_size() const noexcept {
+		return parsed_response_.body_size;
+	}
+	/*
+		Returns the size of the body as it was sent by the server, before any content decoding.
+		Comparing it with get_body_size() gives the compression ratio of the response.
+	*/
+	[[nodiscard]]
+	std::size_t get_encoded_body_size() const noexcept {
+		return parsed_response_.encoded_body_size;
+	}
+
+	/*
+		Returns the trailer fields that were sent after a body with the chunked transfer encoding.
+		The returned headers shall not outlive this Response object.
+	*/
+	[[nodiscard]]
+	std::pmr::vector<Header> get_trailers() const {
+		return algorithms::parse_headers_string(parsed_response_.trailers_string);
+	}
+	/*
+		Returns the value of the first trailer field with the given name, 
+		or std::nullopt if there is none. See get_trailers.
+	*/
+	[[nodiscard]]
+	std::optional<std::string_view> get_trailer_value(std::string_view const name) const {
+		return algorithms::find_header_value_in_string(parsed_response_.trailers_string, name);
+	}
+	/*
+		Returns the chunk extensions of all chunks of a body with the chunked transfer encoding,
+		in the order that they were received.
+		The returned extensions shall not outlive this Response object.
+	*/
+	[[nodiscard]]
+	std::pmr::vector<algorithms::ChunkExtension> get_chunk_extensions() const {
+		return algorithms::parse_chunk_extensions(parsed_response_.chunk_extensions_string);
+	}
 
 	[[nodiscard]]
 	std::string_view get_url() const {
-		return url_;
+		return url_.get();
 	}
 
 	/*
@@ -1283,143 +2686,646 @@ public:
 	Response(Response&&) noexcept = default;
 	Response& operator=(Response&&) noexcept = default;
 
-	Response(algorithms::ParsedResponse&& parsed_response, std::string&& url, const std::chrono::duration<double, std::milli>&& total_time) :
+	/*
+		The url is shared with the request, for example a PreparedRequest that is sent many times.
+	*/
+	Response(algorithms::ParsedResponse&& parsed_response, utils::SharedString url, std::chrono::duration<double, std::milli> const total_time) :
 		parsed_response_{std::move(parsed_response)},
 		url_{std::move(url)},
-		total_time_{std::move(total_time)}
+		total_time_{total_time}
 	{}
 
 private:
+	friend class ResponseBuffers;
+
 	algorithms::ParsedResponse parsed_response_;
-	std::string url_;
+	utils::SharedString url_;
 	std::chrono::duration<double, std::milli> total_time_;
 };
 
+/*
+	Storage that is reused from one response to the next, so that buffers that have grown 
+	to fit earlier responses do not have to grow again. This avoids repeated reallocation 
+	when many similar requests are sent one after the other.
+	Pass it to Request::send or PreparedRequest::send, and give each Response back with recycle 
+	when it is no longer needed so that the storage of its body is reused as well.
+	It must not be used for multiple requests at the same time.
+*/
+class ResponseBuffers {
+public:
+	/*
+		Takes over the storage of the body of a response that is no longer needed.
+		The body of the response is empty afterwards.
+	*/
+	void recycle(Response&& response) noexcept {
+		keep_larger_(body_, std::move(response.parsed_response_.body_data));
+		response.parsed_response_.body_data.clear();
+	}
+
+private:
+	friend class algorithms::ResponseParser;
+
+	/*
+		Storage is only reused if it was allocated from memory_resource,
+		because otherwise it would have to be copied anyway.
+	*/
+	[[nodiscard]]
+	static utils::pmr::DataVector take_(std::optional<utils::pmr::DataVector>& buffer, std::pmr::memory_resource* const memory_resource) {
+		if (buffer && buffer->get_allocator() == std::pmr::polymorphic_allocator<std::byte>{memory_resource}) {
+			auto result = *std::move(buffer);
+			buffer.reset();
+			result.clear();
+			return result;
+		}
+		return utils::pmr::DataVector(memory_resource);
+	}
+	static void keep_larger_(std::optional<utils::pmr::DataVector>& buffer, utils::pmr::DataVector&& data) noexcept {
+		if (!buffer || data.capacity() > buffer->capacity()) {
+			buffer.emplace(std::move(data));
+		}
+	}
+
+	[[nodiscard]]
+	utils::pmr::DataVector take_receive_buffer_(std::pmr::memory_resource* const memory_resource) {
+		return take_(receive_buffer_, memory_resource);
+	}
+	[[nodiscard]]
+	utils::pmr::DataVector take_body_(std::pmr::memory_resource* const memory_resource) {
+		return take_(body_, memory_resource);
+	}
+	void give_back_receive_buffer_(utils::pmr::DataVector&& buffer) noexcept {
+		keep_larger_(receive_buffer_, std::move(buffer));
+	}
+
+	std::optional<utils::pmr::DataVector> receive_buffer_;
+	std::optional<utils::pmr::DataVector> body_;
+};
+
+/*
+	Enumeration of the content codings that a response body can be compressed with.
+	See the Content-Encoding header.
+*/
+enum class ContentEncoding {
+	Identity,
+	Gzip,
+	Deflate,
+	Brotli,
+	Zstd,
+};
+
+/*
+	Converts a ContentEncoding to the token that is used for it in HTTP headers.
+	For example, ContentEncoding::Brotli becomes std::string_view{"br"}.
+*/
+[[nodiscard]]
+inline std::string_view content_encoding_to_string(ContentEncoding const encoding) {
+	using enum ContentEncoding;
+	switch (encoding) {
+		case Identity: return "identity";
+		case Gzip:     return "gzip";
+		case Deflate:  return "deflate";
+		case Brotli:   return "br";
+		case Zstd:     return "zstd";
+	}
+	utils::unreachable();
+}
+
+/*
+	Returns whether the library was built with support for decoding a content encoding.
+	Gzip and deflate need zlib, brotli needs the brotli decoder library and zstd needs libzstd.
+*/
+[[nodiscard]]
+bool get_is_content_encoding_supported(ContentEncoding encoding) noexcept;
+
+/*
+	Returns whether the library was built with support for compressing data with a content encoding.
+	Gzip and deflate need zlib and zstd needs libzstd. Brotli compression is not supported, 
+	and neither is identity, which is not a compression and must not be sent in a Content-Encoding header.
+*/
+[[nodiscard]]
+bool get_is_content_compression_supported(ContentEncoding encoding) noexcept;
+
 namespace algorithms {
 
+/*
+	A callable that receives body data as it arrives, instead of 
+	the body being accumulated in the response.
+*/
+using BodySink = std::function<void(std::span<std::byte const>)>;
+
+/*
+	A callable that produces body data piece by piece, instead of the whole body being in memory.
+	It fills the buffer it is given with the next piece of the body and returns the number of
+	bytes that were written. Returning 0 means that the end of the body has been reached.
+*/
+using BodySource = std::function<std::size_t(std::span<std::byte>)>;
+
+/*
+	Parses a single content coding token, for example from a Content-Encoding header value.
+	Returns an empty optional if the content coding is unknown.
+*/
+[[nodiscard]]
+constexpr std::optional<ContentEncoding> parse_content_encoding(std::string_view const string) noexcept {
+	using enum ContentEncoding;
+	for (auto const encoding : {Identity, Gzip, Deflate, Brotli, Zstd}) {
+		if (utils::equal_ascii_case_insensitive(string, content_encoding_to_string(encoding))) {
+			return encoding;
+		}
+	}
+	// Deprecated alias that is still accepted by servers.
+	if (utils::equal_ascii_case_insensitive(string, "x-gzip")) {
+		return Gzip;
+	}
+	return {};
+}
+
+/*
+	Returns the value of an Accept-Encoding header that lists 
+	all content encodings that the library can decode.
+	It is empty if no content encodings are supported.
+*/
+[[nodiscard]]
+inline std::string get_accept_encoding_header_value() {
+	using enum ContentEncoding;
+	auto result = std::string{};
+	for (auto const encoding : {Gzip, Deflate, Brotli, Zstd}) {
+		if (get_is_content_encoding_supported(encoding)) {
+			if (!result.empty()) {
+				result += ", ";
+			}
+			result += content_encoding_to_string(encoding);
+		}
+	}
+	return result;
+}
+
+/*
+	Decompresses a content encoded body incrementally, as it is received.
+	Errors in the encoded data are reported by throwing errors::ResponseParsingFailed.
+*/
+class ContentDecoder {
+public:
+	/*
+		Decodes the next piece of encoded data. 
+		The decoded data is passed to output in one or more slices, 
+		which are only valid during each call to output.
+	*/
+	void decode(std::span<std::byte const> data, BodySink const& output);
+
+	/*
+		Returns whether the end of the encoded data has been reached.
+		If the body ends before this is true, the body was truncated.
+	*/
+	[[nodiscard]]
+	bool get_is_finished() const noexcept;
+
+	/*
+		Throws errors::ResponseParsingFailed if the encoding is not supported.
+		See get_is_content_encoding_supported.
+	*/
+	explicit ContentDecoder(ContentEncoding encoding);
+	~ContentDecoder(); // = default in .cpp
+
+	ContentDecoder(ContentDecoder&&) noexcept; // = default in .cpp
+	ContentDecoder& operator=(ContentDecoder&&) noexcept; // = default in .cpp
+
+	ContentDecoder(ContentDecoder const&) = delete;
+	ContentDecoder& operator=(ContentDecoder const&) = delete;
+
+private:
+	class Implementation;
+	std::unique_ptr<Implementation> implementation_;
+};
+
+/*
+	Compresses data with a content encoding incrementally, for example to compress a request body.
+*/
+class ContentEncoder {
+public:
+	/*
+		Compresses the next piece of data. The compressed data is passed to output in zero 
+		or more slices, which are only valid during each call to output.
+	*/
+	void encode(std::span<std::byte const> data, BodySink const& output);
+	/*
+		Ends the compressed data and passes the rest of it to output.
+		No more data can be encoded after this.
+	*/
+	void finish(BodySink const& output);
+
+	/*
+		The compression level is specific to the encoding: 0 to 9 for gzip and deflate, 
+		and 1 to 22 for zstd. Higher levels compress better but slower.
+		If it is not given, the default level of the compression library is used.
+		Throws std::invalid_argument if the encoding is not supported or the level is out of range.
+		See get_is_content_compression_supported.
+	*/
+	explicit ContentEncoder(ContentEncoding encoding, std::optional<int> level = {});
+	~ContentEncoder(); // = default in .cpp
+
+	ContentEncoder(ContentEncoder&&) noexcept; // = default in .cpp
+	ContentEncoder& operator=(ContentEncoder&&) noexcept; // = default in .cpp
+
+	ContentEncoder(ContentEncoder const&) = delete;
+	ContentEncoder& operator=(ContentEncoder const&) = delete;
+
+private:
+	class Implementation;
+	std::unique_ptr<Implementation> implementation_;
+};
+
+/*
+	Returns a body source that produces the data of body_source compressed with a content encoding.
+	body_source is read and compressed a piece at a time, as the compressed data is requested.
+	See ContentEncoder for the meaning of level and the errors that can be thrown.
+	std::length_error is thrown if body_source returns a size that is larger than the buffer it was given.
+*/
+[[nodiscard]]
+inline BodySource make_compressing_body_source(BodySource body_source, ContentEncoding const encoding, std::optional<int> const level = {}) {
+	struct State {
+		BodySource body_source;
+		ContentEncoder encoder;
+		std::array<std::byte, std::size_t{1} << 14> input_buffer;
+		// Compressed data that has not been returned yet, starting at output_offset.
+		utils::DataVector output;
+		std::size_t output_offset{};
+		bool is_finished{false};
+	};
+	// BodySource must be copyable, which ContentEncoder is not.
+	auto state = std::make_shared<State>(std::move(body_source), ContentEncoder{encoding, level});
+
+	return [state = std::move(state)](std::span<std::byte> const buffer) -> std::size_t {
+		auto const output_sink = BodySink{[&state = *state](std::span<std::byte const> const data) {
+			utils::append_to_vector(state.output, data);
+		}};
+
+		// The encoder may need more than one piece of input before it produces any output.
+		while (state->output_offset == state->output.size()) {
+			if (state->is_finished) {
+				return 0;
+			}
+			state->output.clear();
+			state->output_offset = 0;
+
+			auto const size = state->body_source(state->input_buffer);
+			if (size > state->input_buffer.size()) {
+				throw std::length_error{"The body source returned a size that is larger than its buffer."};
+			}
+			if (size == 0) {
+				state->encoder.finish(output_sink);
+				state->is_finished = true;
+			}
+			else state->encoder.encode(std::span{state->input_buffer}.first(size), output_sink);
+		}
+
+		auto const size = std::min(buffer.size(), state->output.size() - state->output_offset);
+		std::ranges::copy(std::span{state->output}.subspan(state->output_offset, size), buffer.begin());
+		state->output_offset += size;
+		return size;
+	};
+}
+
+/*
+	Decodes a body with the chunked transfer encoding (https://www.rfc-editor.org/rfc/rfc9112#section-7.1).
+	It is a state machine that looks at each byte of the chunk framing once and copies chunk data in bulk,
+	so chunk size lines, extensions and trailers may be split between packets anywhere.
+	Chunk extensions and the trailer section are kept, and parsing ends exactly 
+	at the empty line that ends the message.
+*/
 class ChunkyBodyParser {
 public:
+	/*
+		Parses the next part of the chunked body.
+		The decoded body is returned when the end of the message has been reached.
+		Any data after the end of the message is not parsed, see get_end_offset.
+	*/
 	[[nodiscard]]
-	std::optional<utils::DataVector> parse_new_data(std::span<std::byte const> const new_data) {
-		if (has_returned_result_) {
+	std::optional<utils::pmr::DataVector> parse_new_data(std::span<std::byte const> const new_data) {
+		if (state_ == State_::Finished) {
 			return {};
 		}
-		if (is_finished_) {
-			has_returned_result_ = true;
-			return std::move(result_);
-		}
-		
-		auto cursor = start_parse_offset_;
-		
-		while (true) {
-			if (cursor >= new_data.size()) {
-				start_parse_offset_ = cursor - new_data.size();
-				return {};
-			}
-			if (auto const cursor_offset = parse_next_part_(new_data.subspan(cursor))) {
-				cursor += cursor_offset;
-			}
-			else {
-				has_returned_result_ = true;
+
+		auto const data = utils::data_to_string(new_data);
+
+		for (auto position = std::size_t{}; position < data.size();) {
+			position = parse_next_part_(data, position);
+			if (state_ == State_::Finished) {
+				end_offset_ = position;
 				return std::move(result_);
 			}
 		}
+		return {};
+	}
+	/*
+		Parses the next part of the chunked body, and passes the decoded body data 
+		to body_sink instead of accumulating it. An empty vector is returned 
+		when the end of the message has been reached.
+	*/
+	[[nodiscard]]
+	std::optional<utils::pmr::DataVector> parse_new_data(std::span<std::byte const> const new_data, BodySink const& body_sink) {
+		body_sink_ = &body_sink;
+		auto const reset_body_sink = utils::Cleanup{[this]{ body_sink_ = nullptr; }};
+		return parse_new_data(new_data);
 	}
 	[[nodiscard]]
 	std::span<std::byte const> get_result_so_far() const {
 		return result_;
 	}
+	/*
+		Returns the number of decoded body bytes so far, 
+		including any that were passed to the body sink.
+	*/
+	[[nodiscard]]
+	std::size_t get_result_size_so_far() const noexcept {
+		return result_size_so_far_;
+	}
+	/*
+		Returns the chunk extensions of all chunks so far in the order that they were received,
+		each list of extensions starting with its semicolon. See parse_chunk_extensions.
+	*/
+	[[nodiscard]]
+	std::string_view get_chunk_extensions_string() const noexcept {
+		return chunk_extensions_;
+	}
+	/*
+		Returns the trailer section, which has the same format as the header lines of a response.
+		It is complete when the end of the message has been reached.
+	*/
+	[[nodiscard]]
+	std::string_view get_trailers_string() const noexcept {
+		return trailers_;
+	}
+	/*
+		Returns the position right after the end of the message in the data 
+		that was passed to the last call of parse_new_data, once the result has been returned.
+	*/
+	[[nodiscard]]
+	std::size_t get_end_offset() const noexcept {
+		return end_offset_;
+	}
+
+	/*
+		The result is allocated with allocator.
+	*/
+	explicit ChunkyBodyParser(std::pmr::polymorphic_allocator<> const allocator = {}) :
+		result_(allocator),
+		chunk_extensions_(allocator),
+		trailers_(allocator)
+	{}
+	/*
+		The result is accumulated in result, which is cleared first, so that its capacity is reused.
+		The result is allocated with the allocator of result.
+	*/
+	explicit ChunkyBodyParser(utils::pmr::DataVector&& result) :
+		result_(std::move(result)),
+		chunk_extensions_(result_.get_allocator()),
+		trailers_(result_.get_allocator())
+	{
+		result_.clear();
+	}
 
 private:
-	static constexpr auto newline = std::string_view{"\r\n"};
+	enum class State_ : std::uint8_t {
+		ChunkSize,
+		ChunkSizeEnd, // After the digits of the chunk size, before any extensions.
+		ChunkExtensions,
+		ChunkSizeLineFeed,
+		ChunkData,
+		ChunkDataEnd,
+		ChunkDataLineFeed,
+		Trailers,
+		Finished,
+	};
 
 	/*
-		"part" refers to a separately parsed unit of data.
-		This partitioning makes the parsing algorithm simpler.
-		Returns the position where the part ended.
-		It may be past the end of the part.
+		Parses the data that the current state applies to, starting at position.
+		Returns the position where the next state starts.
 	*/
 	[[nodiscard]]
-	std::size_t parse_next_part_(std::span<std::byte const> const new_data) {
-		if (chunk_size_left_) {
-			return parse_chunk_body_part_(new_data);
+	std::size_t parse_next_part_(std::string_view const data, std::size_t position) {
+		switch (state_) {
+			case State_::ChunkSize:
+				for (; position < data.size(); ++position) {
+					auto const digit = utils::hex_digit_value(data[position]);
+					if (digit < 0) {
+						if (!has_chunk_size_digits_) {
+							throw errors::ResponseParsingFailed{"Failed parsing http body chunk size."};
+						}
+						// Most chunk size lines end right after the digits.
+						if (get_is_newline_at_(data, position)) {
+							end_chunk_size_line_();
+							return position + newline.size();
+						}
+						state_ = State_::ChunkSizeEnd;
+						break;
+					}
+					if (chunk_size_left_ > std::numeric_limits<std::size_t>::max() >> 4) {
+						throw errors::ResponseParsingFailed{"Http body chunk size is too large."};
+					}
+					chunk_size_left_ = chunk_size_left_ << 4 | static_cast<std::size_t>(digit);
+					has_chunk_size_digits_ = true;
+				}
+				return position;
+			case State_::ChunkSizeEnd:
+				switch (data[position]) {
+					case ' ': 
+					case '\t':
+						break;
+					case ';':
+						chunk_extensions_ += ';';
+						state_ = State_::ChunkExtensions;
+						break;
+					case '\r':
+						state_ = State_::ChunkSizeLineFeed;
+						break;
+					case '\n':
+						end_chunk_size_line_();
+						break;
+					default:
+						throw errors::ResponseParsingFailed{"Failed parsing http body chunk size."};
+				}
+				return position + 1;
+			case State_::ChunkExtensions: {
+				// Quoted extension values can not contain line breaks, so the line ends at the first one.
+				auto const line_end = data.find('\n', position);
+				chunk_extensions_ += data.substr(position, line_end - position);
+				if (line_end == std::string_view::npos) {
+					return data.size();
+				}
+				if (chunk_extensions_.ends_with('\r')) {
+					chunk_extensions_.pop_back();
+				}
+				end_chunk_size_line_();
+				return line_end + 1;
+			}
+			case State_::ChunkSizeLineFeed:
+				if (data[position] != '\n') {
+					throw errors::ResponseParsingFailed{"Failed parsing http body chunk size."};
+				}
+				end_chunk_size_line_();
+				return position + 1;
+			case State_::ChunkData: {
+				auto const size = std::min(chunk_size_left_, data.size() - position);
+				consume_body_data_(utils::string_to_data<std::byte>(data.substr(position, size)));
+				chunk_size_left_ -= size;
+				if (chunk_size_left_ > 0) {
+					return position + size;
+				}
+				if (get_is_newline_at_(data, position + size)) {
+					start_chunk_();
+					return position + size + newline.size();
+				}
+				state_ = State_::ChunkDataEnd;
+				return position + size;
+			}
+			case State_::ChunkDataEnd:
+				if (data[position] == '\r') {
+					state_ = State_::ChunkDataLineFeed;
+					return position + 1;
+				}
+				[[fallthrough]];
+			case State_::ChunkDataLineFeed:
+				if (data[position] != '\n') {
+					throw errors::ResponseParsingFailed{"Http body chunk data is not followed by a line break."};
+				}
+				start_chunk_();
+				return position + 1;
+			case State_::Trailers:
+				return parse_trailers_part_(data, position);
+			case State_::Finished:
+				break;
 		}
-		else return parse_chunk_separator_part_(new_data);
+		utils::unreachable();
 	}
 
 	[[nodiscard]]
-	std::size_t parse_chunk_body_part_(std::span<std::byte const> const new_data) {
-		if (chunk_size_left_ > new_data.size())
-		{
-			chunk_size_left_ -= new_data.size();
-			utils::append_to_vector(result_, new_data);
-			return new_data.size();
-		}
-		else {
-			utils::append_to_vector(result_, new_data.first(chunk_size_left_));
-
-			// After each chunk, there is a \r\n and then the size of the next chunk.
-			// We skip the \r\n so the next part starts at the size number.
-			auto const part_end = chunk_size_left_ + newline.size();
-			chunk_size_left_ = 0;
-			return part_end;
-		}
+	static bool get_is_newline_at_(std::string_view const data, std::size_t const position) noexcept {
+		return position + 1 < data.size() && data[position] == '\r' && data[position + 1] == '\n';
+	}
+	void start_chunk_() {
+		state_ = State_::ChunkSize;
+		has_chunk_size_digits_ = false;
+	}
+	void end_chunk_size_line_() {
+		// The last chunk has size 0 and is followed by the trailer section.
+		state_ = chunk_size_left_ == 0 ? State_::Trailers : State_::ChunkData;
 	}
 
 	[[nodiscard]]
-	std::size_t parse_chunk_separator_part_(std::span<std::byte const> const new_data) {
-		auto const data_string = utils::data_to_string(new_data);
-
-		auto const first_newline_character_pos = data_string.find(newline[0]);
-		
-		if (first_newline_character_pos == std::string_view::npos) {
-			chunk_size_string_buffer_ += data_string;
-			return new_data.size();
+	std::size_t parse_trailers_part_(std::string_view const data, std::size_t const position) {
+		auto const line_end = data.find('\n', position);
+		trailers_ += data.substr(position, line_end - position);
+		if (line_end == std::string_view::npos) {
+			return data.size();
 		}
-		else if (chunk_size_string_buffer_.empty()) {
-			parse_chunk_size_left_(data_string.substr(0, first_newline_character_pos));
+
+		if (auto const line = std::string_view{trailers_}.substr(trailer_line_start_); line.empty() || line == "\r") {
+			// The empty line that ends the message is not part of the trailer section,
+			// and neither is the line break before it.
+			trailers_.resize(trailer_line_start_ >= newline.size() ? trailer_line_start_ - newline.size() : 0);
+			state_ = State_::Finished;
 		}
 		else {
-			chunk_size_string_buffer_ += data_string.substr(0, first_newline_character_pos);
-			parse_chunk_size_left_(chunk_size_string_buffer_);
-			chunk_size_string_buffer_.clear();
-		}
-
-		if (chunk_size_left_ == 0) {
-			is_finished_ = true;
-			return 0;
+			if (!line.ends_with('\r')) {
+				trailers_ += '\r';
+			}
+			trailers_ += '\n';
+			trailer_line_start_ = trailers_.size();
 		}
-		
-		return first_newline_character_pos + newline.size();
+		return line_end + 1;
 	}
 
-	void parse_chunk_size_left_(std::string_view const string) {
-		// hexadecimal
-		if (auto const result = utils::string_to_integral<std::size_t>(string, 16)) {
-			chunk_size_left_ = *result;
+	void consume_body_data_(std::span<std::byte const> const data) {
+		result_size_so_far_ += data.size();
+		if (body_sink_) {
+			(*body_sink_)(data);
+		}
+		else {
+			utils::append_to_vector(result_, data);
 		}
-		else throw errors::ResponseParsingFailed{"Failed parsing http body chunk size."};
 	}
+
+	static constexpr auto newline = std::string_view{"\r\n"};
 	
-	utils::DataVector result_;
+	utils::pmr::DataVector result_;
+	std::size_t result_size_so_far_{};
 
-	bool is_finished_{false};
-	bool has_returned_result_{false};
+	// This is only set during a call of parse_new_data with a body sink.
+	BodySink const* body_sink_{};
 
-	std::size_t start_parse_offset_{};
-	
-	std::string chunk_size_string_buffer_;
+	State_ state_{State_::ChunkSize};
 	std::size_t chunk_size_left_{};
+	bool has_chunk_size_digits_{false};
+	std::size_t end_offset_{};
+
+	std::pmr::string chunk_extensions_;
+	std::pmr::string trailers_;
+	// The position in trailers_ where the trailer line that is being received starts.
+	std::size_t trailer_line_start_{};
 };
 
 struct ResponseCallbacks {
 	std::function<void(ResponseProgressRaw&)> handle_raw_progress;
 	std::function<void(ResponseProgressHeaders&)> handle_headers;
 	std::function<void(ResponseProgressBody&)> handle_body_progress;
+	/*
+		If this is set, the body is passed here as it is received instead of being 
+		stored in the response, and the parser only keeps the most recent packet in memory.
+	*/
+	BodySink handle_body_data;
 	std::function<void(Response&)> handle_finish;
 	std::function<void()> handle_stop;
 };
 
+/*
+	Options that change how a response is parsed.
+*/
+struct ResponseParsingOptions {
+	/*
+		If this is true and the response has a Content-Encoding that is supported 
+		(see get_is_content_encoding_supported), the body is decoded while it is received.
+		Body progress callbacks and body sinks then see the decoded data.
+	*/
+	bool is_decoding_content{false};
+	/*
+		If this is true, the headers are only parsed when they are first accessed.
+		Until then, only the headers that are needed to receive the body are searched for.
+		This saves work when the headers are not used. 
+		The headers of a response can still be accessed from several threads at once, see ParsedResponse::get_headers.
+	*/
+	bool is_parsing_headers_lazily{false};
+	/*
+		The memory resource that the response and the buffers that are used to receive it are allocated from.
+		The status line and headers of each response are allocated from a single block of it,
+		which is freed all at once when the response is destroyed.
+		If this is nullptr, the default memory resource is used, and the status line and headers 
+		are allocated from it separately instead.
+	*/
+	std::pmr::memory_resource* memory_resource{};
+	/*
+		If this is not nullptr, the response is received into storage that is reused from earlier responses.
+		See ResponseBuffers.
+	*/
+	ResponseBuffers* response_buffers{};
+	/*
+		If this is not 0, the body is stored in blocks of this many bytes (see utils::SegmentedData)
+		instead of in one contiguous buffer, and only the most recent packet is kept in the receive buffer.
+		Large bodies and chunked bodies of unknown size are then received without 
+		reallocating and copying the data that has been received so far.
+	*/
+	std::size_t body_segment_size{};
+	/*
+		Whether the response is to a HEAD request, in which case it has no body 
+		even if it has a Content-Length or Transfer-Encoding header.
+	*/
+	bool is_response_to_head_request{false};
+
+	[[nodiscard]]
+	std::pmr::memory_resource* get_memory_resource() const noexcept {
+		return memory_resource ? memory_resource : std::pmr::get_default_resource();
+	}
+};
+
 /*
 	Separate, testable module that parses a http response.
 	It has support for optional response progress callbacks.
@@ -1435,8 +3341,14 @@ public:
 		if (is_done_) {
 			return {};
 		}
+
+		if (is_streaming_body_) {
+			// Body data that has already been consumed is not kept.
+			buffer_.clear();
+			body_start_ = 0;
+		}
 		
-		auto const new_data_start = buffer_.size();
+		auto new_data_start = buffer_.size();
 		
 		utils::append_to_vector(buffer_, data);
 
@@ -1449,38 +3361,108 @@ public:
 		}
 		
 		if (!is_done_ && result_.headers_string.empty()) {
-			try_parse_headers_(new_data_start);
+			new_data_start = try_parse_headers_(new_data_start);
 		}
 
 		if (!is_done_ && !result_.headers_string.empty()) {
 			if (chunky_body_parser_) {
 				parse_new_chunky_body_data_(new_data_start);
 			}
+			else if (is_streaming_body_) {
+				parse_new_streamed_regular_body_data_(new_data_start);
+			}
 			else {
 				parse_new_regular_body_data_(new_data_start);
 			}
 		}
 		if (is_done_) {
-			return std::move(result_);
+			return take_result_();
 		}
 		return {};
 	}
+	/*
+		Must be called when the server has closed the connection before parse_new_data returned the response.
+		If the body of the response is ended by closing the connection, which is the case when 
+		it has neither a Content-Length header nor the chunked transfer encoding, the response is returned.
+		Otherwise, the response is incomplete and nothing is returned.
+	*/
+	[[nodiscard]]
+	std::optional<ParsedResponse> finish_at_connection_close() {
+		if (is_done_ || !is_body_until_close_) {
+			return {};
+		}
+		finish_body_();
+		return take_result_();
+	}
 
 	ResponseParser() = default;
-	ResponseParser(ResponseCallbacks& callbacks) :
+	explicit ResponseParser(ResponseParsingOptions const options) :
+		buffer_(options.get_memory_resource()),
+		result_{make_empty_result_(options)},
+		options_{options}
+	{
+		reuse_response_buffers_();
+		if (options_.body_segment_size) {
+			result_.body_segments.set_segment_size(options_.body_segment_size);
+		}
+	}
+	ResponseParser(ResponseCallbacks const& callbacks, ResponseParsingOptions const options = {}) :
+		buffer_(options.get_memory_resource()),
+		result_{make_empty_result_(options)},
+		options_{options},
 		callbacks_{&callbacks}
-	{}
-	
+	{
+		reuse_response_buffers_();
+		if (options_.body_segment_size) {
+			result_.body_segments.set_segment_size(options_.body_segment_size);
+		}
+	}
+
+	ResponseParser(ResponseParser&&) noexcept = default;
+	ResponseParser& operator=(ResponseParser&&) noexcept = default;
+	
 private:
+	/*
+		The arena that the metadata of a response is allocated from is only worth its size 
+		when a memory resource has been chosen for the response.
+	*/
+	[[nodiscard]]
+	static ParsedResponse make_empty_result_(ResponseParsingOptions const& options) {
+		return options.memory_resource ? ParsedResponse{options.memory_resource} : ParsedResponse{};
+	}
+	void reuse_response_buffers_() {
+		if (options_.response_buffers) {
+			buffer_ = options_.response_buffers->take_receive_buffer_(options_.get_memory_resource());
+			result_.body_data = options_.response_buffers->take_body_(options_.get_memory_resource());
+		}
+	}
+	[[nodiscard]]
+	ParsedResponse take_result_() {
+		if (options_.response_buffers) {
+			options_.response_buffers->give_back_receive_buffer_(std::move(buffer_));
+		}
+		return std::move(result_);
+	}
 	void finish_() {
 		is_done_ = true;
 		if (callbacks_ && (*callbacks_)->handle_stop) {
 			(*callbacks_)->handle_stop();
 		}
 	}
+	void finish_body_() {
+		if (content_decoder_ && result_.encoded_body_size > 0 && !content_decoder_->get_is_finished()) {
+			throw errors::ResponseParsingFailed{"The response body ended before the end of its content encoded data."};
+		}
+		finish_();
+	}
 
-	void try_parse_headers_(std::size_t const new_data_start) {
-		if (auto const headers_string = try_extract_headers_string_(new_data_start))
+	/*
+		Returns the position in buffer_ where the new data starts,
+		which changes if interim responses are removed from the start of buffer_.
+	*/
+	[[nodiscard]]
+	std::size_t try_parse_headers_(std::size_t new_data_start) {
+		while (auto const headers_string = try_extract_headers_string_(new_data_start))
 		{
 			result_.headers_string = *headers_string;
 
@@ -1490,13 +3472,28 @@ private:
 			}
 			
 			result_.status_line = algorithms::parse_status_line(
-				std::string_view{result_.headers_string}.substr(0, status_line_end)
+				std::string_view{result_.headers_string}.substr(0, status_line_end),
+				result_.headers_string.get_allocator()
 			);
 
+			if (get_is_interim_status_code(result_.status_line.status_code)) {
+				// Interim responses, such as 100 Continue and 103 Early Hints, are 
+				// followed by the final response to the same request (RFC 9110, section 15.2).
+				result_.headers_string.clear();
+				new_data_start -= std::min(new_data_start, body_start_);
+				buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(body_start_));
+				body_start_ = 0;
+				continue;
+			}
+
 			if (result_.headers_string.size() > status_line_end) {
-				result_.headers = algorithms::parse_headers_string(
-					std::string_view{result_.headers_string}.substr(status_line_end)
-				);
+				algorithms::unfold_header_lines(std::span{result_.headers_string}.subspan(status_line_end));
+				if (options_.is_parsing_headers_lazily) {
+					result_.set_headers_pending_();
+				}
+				else {
+					result_.parse_headers_();
+				}
 			}
 
 			if (callbacks_ && (*callbacks_)->handle_headers) {
@@ -1507,17 +3504,79 @@ private:
 				}
 			}
 
-			if (auto const body_size_try = get_body_size_()) {
-				body_size_ = *body_size_try;
+			if (options_.is_decoding_content) {
+				try_set_up_content_decoder_();
+			}
+			is_streaming_body_ = get_is_using_body_sink_() || content_decoder_ || options_.body_segment_size;
+
+			set_up_body_framing_();
+			break;
+		}
+		return new_data_start;
+	}
+	/*
+		Determines how the end of the body is found, as described in RFC 9112, section 6.3.
+	*/
+	void set_up_body_framing_() {
+		if (get_is_without_body_()) {
+			body_size_ = 0;
+		}
+		else if (auto const transfer_encoding = result_.find_header_value_without_parsing_(KnownHeader::TransferEncoding)) {
+			// Transfer-Encoding overrides Content-Length.
+			if (!get_is_chunked_transfer_encoding(*transfer_encoding)) {
+				set_up_body_until_close_();
+			}
+			else if (is_streaming_body_) {
+				chunky_body_parser_.emplace(buffer_.get_allocator());
+			}
+			else {
+				chunky_body_parser_.emplace(std::move(result_.body_data));
+			}
+		}
+		else if (auto const content_length = result_.find_header_value_without_parsing_(KnownHeader::ContentLength)) {
+			if (auto const size = utils::string_to_integral<std::size_t>(*content_length)) {
+				body_size_ = *size;
 			}
-			else if (auto const transfer_encoding = algorithms::find_header_by_name(result_.headers, "transfer-encoding");
-				transfer_encoding && transfer_encoding->value == "chunked")
+			else throw errors::ResponseParsingFailed{"The Content-Length header of the response is invalid."};
+		}
+		else {
+			set_up_body_until_close_();
+		}
+	}
+	/*
+		The body of a response without a Content-Length header or the chunked transfer encoding 
+		is ended by the server closing the connection, see finish_at_connection_close.
+	*/
+	void set_up_body_until_close_() {
+		is_body_until_close_ = true;
+		is_streaming_body_ = true;
+		body_size_ = std::numeric_limits<std::size_t>::max();
+	}
+	/*
+		Responses to HEAD requests and responses with the status codes 1xx, 204 and 304 never have a body.
+	*/
+	[[nodiscard]]
+	bool get_is_without_body_() const noexcept {
+		auto const status_code = result_.status_line.status_code;
+		return options_.is_response_to_head_request || static_cast<int>(status_code) / 100 == 1 || 
+			status_code == StatusCode::NoContent || status_code == StatusCode::NotModified;
+	}
+	void try_set_up_content_decoder_() {
+		if (auto const content_encoding = result_.find_header_value_without_parsing_(KnownHeader::ContentEncoding)) {
+			// Only a single content coding is decoded. 
+			// Bodies with multiple codings applied are kept as they are.
+			if (auto const encoding = parse_content_encoding(*content_encoding);
+				encoding && *encoding != ContentEncoding::Identity && get_is_content_encoding_supported(*encoding))
 			{
-				chunky_body_parser_ = ChunkyBodyParser{};
+				content_decoder_.emplace(*encoding);
 			}
 		}
 	}
 	[[nodiscard]]
+	bool get_is_using_body_sink_() const {
+		return callbacks_ && static_cast<bool>((*callbacks_)->handle_body_data);
+	}
+	[[nodiscard]]
 	std::optional<std::string_view> try_extract_headers_string_(std::size_t const new_data_start) {
 		// '\n' line endings are not conformant with the HTTP standard.
 		for (std::string_view const empty_line : {"\r\n\r\n", "\n\n"})
@@ -1535,33 +3594,105 @@ private:
 		}
 		return {};
 	}
+
+	/*
+		Used when the body is streamed. Receives the body data after 
+		any transfer encoding has been removed, but before content decoding.
+	*/
+	void consume_encoded_body_data_(std::span<std::byte const> const data) {
+		result_.encoded_body_size += data.size();
+		if (content_decoder_) {
+			content_decoder_->decode(data, get_decoded_body_sink_());
+		}
+		else {
+			consume_decoded_body_data_(data);
+		}
+	}
+	/*
+		The body sinks refer to the parser, so they are created when they are used 
+		instead of being stored in it. That way the parser can be moved.
+	*/
 	[[nodiscard]]
-	std::optional<std::size_t> get_body_size_() const {
-		if (auto const content_length_string = 
-				algorithms::find_header_by_name(result_.headers, "content-length")) 
-		{
-			if (auto const parse_result = 
-					utils::string_to_integral<std::size_t>(content_length_string->value)) 
-			{
-				return *parse_result;
-			}
+	BodySink get_encoded_body_sink_() {
+		return [this](std::span<std::byte const> const data) { consume_encoded_body_data_(data); };
+	}
+	[[nodiscard]]
+	BodySink get_decoded_body_sink_() {
+		return [this](std::span<std::byte const> const data) { consume_decoded_body_data_(data); };
+	}
+	void consume_decoded_body_data_(std::span<std::byte const> const data) {
+		result_.body_size += data.size();
+		if (get_is_using_body_sink_()) {
+			(*callbacks_)->handle_body_data(data);
 		}
-		return {};
+		else if (options_.body_segment_size) {
+			result_.body_segments.append(data);
+		}
+		else {
+			utils::append_to_vector(result_.body_data, data);
+		}
+	}
+
+	/*
+		Calls the body progress callback when the body is streamed.
+		Returns true if the callback stopped the response.
+	*/
+	[[nodiscard]]
+	bool handle_streamed_body_progress_(std::size_t const new_data_start, std::optional<std::size_t> const total_expected_body_size) {
+		if (!callbacks_ || !(*callbacks_)->handle_body_progress) {
+			return false;
+		}
+		auto body_progress = ResponseProgressBody{
+			ResponseProgressRaw{buffer_, new_data_start}, 
+			result_, 
+			result_.body_data, 
+			result_.body_size, 
+			result_.encoded_body_size,
+			total_expected_body_size
+		};
+		(*callbacks_)->handle_body_progress(body_progress);
+		if (body_progress.raw_progress.is_stopped_) {
+			finish_();
+			return true;
+		}
+		return false;
 	}
 
+	void store_chunk_extensions_and_trailers_() {
+		result_.chunk_extensions_string = chunky_body_parser_->get_chunk_extensions_string();
+		result_.trailers_string = chunky_body_parser_->get_trailers_string();
+		algorithms::unfold_header_lines(result_.trailers_string);
+	}
 	void parse_new_chunky_body_data_(std::size_t const new_data_start) {
 		// May need to add an offset if this packet is
 		// where the headers end and the body starts.
 		auto const body_parse_start = std::max(new_data_start, body_start_);
-		if (auto body = chunky_body_parser_->parse_new_data(std::span{buffer_}.subspan(body_parse_start))) 
+		auto const body_data = std::span{buffer_}.subspan(body_parse_start);
+		auto body = is_streaming_body_ ? 
+			chunky_body_parser_->parse_new_data(body_data, get_encoded_body_sink_()) : 
+			chunky_body_parser_->parse_new_data(body_data);
+		if (body) {
+			store_chunk_extensions_and_trailers_();
+		}
+
+		if (is_streaming_body_) {
+			if (!handle_streamed_body_progress_(new_data_start, {}) && body) {
+				finish_body_();
+			}
+		}
+		else if (body) 
 		{
 			result_.body_data = *std::move(body);
+			result_.body_size = result_.encoded_body_size = result_.body_data.size();
 
 			if (callbacks_ && (*callbacks_)->handle_body_progress) {
 				auto body_progress = ResponseProgressBody{
 					ResponseProgressRaw{buffer_, new_data_start}, 
 					result_, 
-					result_.body_data, {}
+					result_.body_data, 
+					result_.body_size, 
+					result_.encoded_body_size, 
+					{}
 				};
 				(*callbacks_)->handle_body_progress(body_progress);
 			}
@@ -1572,7 +3703,10 @@ private:
 			auto body_progress = ResponseProgressBody{
 				ResponseProgressRaw{buffer_, new_data_start}, 
 				result_, 
-				chunky_body_parser_->get_result_so_far(), {}
+				chunky_body_parser_->get_result_so_far(), 
+				chunky_body_parser_->get_result_size_so_far(), 
+				chunky_body_parser_->get_result_size_so_far(), 
+				{}
 			};
 			(*callbacks_)->handle_body_progress(body_progress);
 			if (body_progress.raw_progress.is_stopped_) {
@@ -1581,16 +3715,34 @@ private:
 		}
 	}
 
+	void parse_new_streamed_regular_body_data_(std::size_t const new_data_start) {
+		auto const body_parse_start = std::max(new_data_start, body_start_);
+		auto const new_body_data = std::span{buffer_}.subspan(body_parse_start)
+			.first(std::min(buffer_.size() - body_parse_start, body_size_ - result_.encoded_body_size));
+
+		if (!new_body_data.empty()) {
+			consume_encoded_body_data_(new_body_data);
+		}
+
+		auto const total_expected_body_size = is_body_until_close_ ? std::optional<std::size_t>{} : body_size_;
+		if (!handle_streamed_body_progress_(new_data_start, total_expected_body_size) && result_.encoded_body_size == body_size_) {
+			finish_body_();
+		}
+	}
+
 	void parse_new_regular_body_data_(std::size_t const new_data_start) {
 		if (buffer_.size() >= body_start_ + body_size_) {
 			auto const body_begin = buffer_.begin() + static_cast<std::ptrdiff_t>(body_start_);
-			result_.body_data = utils::DataVector(body_begin, body_begin + static_cast<std::ptrdiff_t>(body_size_));
+			result_.body_data.assign(body_begin, body_begin + static_cast<std::ptrdiff_t>(body_size_));
+			result_.body_size = result_.encoded_body_size = body_size_;
 
 			if (callbacks_ && (*callbacks_)->handle_body_progress) {
 				auto body_progress = ResponseProgressBody{
 					ResponseProgressRaw{buffer_, new_data_start}, 
 					result_, 
 					result_.body_data, 
+					body_size_,
+					body_size_,
 					body_size_
 				};
 				(*callbacks_)->handle_body_progress(body_progress);
@@ -1603,6 +3755,8 @@ private:
 				ResponseProgressRaw{buffer_, new_data_start}, 
 				result_, 
 				std::span{buffer_}.subspan(body_start_), 
+				buffer_.size() - body_start_,
+				buffer_.size() - body_start_,
 				body_size_
 			};
 			(*callbacks_)->handle_body_progress(body_progress);
@@ -1612,59 +3766,309 @@ private:
 		}
 	}
 
-	utils::DataVector buffer_;
+	utils::pmr::DataVector buffer_;
 
 	ParsedResponse result_;
 	bool is_done_{false};
 
 	std::size_t body_start_{};
 	std::size_t body_size_{};
+	// Whether the body is ended by the server closing the connection.
+	bool is_body_until_close_{false};
+
+	/*
+		The body is streamed if it is passed to a body sink, content decoded or stored in segments.
+		Then only the most recent packet is kept in buffer_.
+	*/
+	bool is_streaming_body_{false};
 
 	std::optional<ChunkyBodyParser> chunky_body_parser_;
+	std::optional<ContentDecoder> content_decoder_;
 
-	std::optional<ResponseCallbacks*> callbacks_;
+	ResponseParsingOptions options_;
+	std::optional<ResponseCallbacks const*> callbacks_;
 };
 
-template<std::size_t buffer_size = std::size_t{1} << 12>
+/*
+	Returns whether the start of the response to a request with "Expect: 100-continue" asks for 
+	the request body, which is the case if its status code is that of an interim response like 100 Continue.
+	Returns nothing if response_start ends before the status code.
+	Data that is not an HTTP response also asks for the body, so that the response parser reports it.
+*/
+[[nodiscard]]
+inline std::optional<bool> get_is_continue_response(std::string_view const response_start) {
+	if (auto const status_code_start = response_start.find(' '); 
+		status_code_start != std::string_view::npos && response_start.size() >= status_code_start + 4)
+	{
+		if (auto const status_code = utils::string_to_integral<int>(response_start.substr(status_code_start + 1, 3))) {
+			return get_is_interim_status_code(static_cast<StatusCode>(*status_code));
+		}
+		return true;
+	}
+	return {};
+}
+
+/*
+	Waits for the server to respond to request headers that contained "Expect: 100-continue".
+	Returns whether the request body should be sent, which is the case if the server responded 
+	with an interim response like 100 Continue or did not respond before the timeout.
+	Returns false if the server sent a final response like 413 Content Too Large, or closed the connection.
+	The response is only peeked, so it is still received by receive_response afterwards.
+*/
 [[nodiscard]]
-inline Response receive_response(Socket const&& socket, std::string&& url, ResponseCallbacks&& callbacks, const std::chrono::steady_clock::time_point&& start_time_point) {
-	auto has_stopped = false;
-	callbacks.handle_stop = [&has_stopped]{ has_stopped = true; };
+inline bool wait_for_continue(Socket const& socket, std::chrono::milliseconds const timeout) {
+	auto const deadline = std::chrono::steady_clock::now() + timeout;
+
+	// Enough for the status code of any status line.
+	auto peek_buffer = std::array<std::byte, 64>();
+
+	while (true) {
+		auto const time_left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+		if (time_left <= std::chrono::milliseconds{} || !socket.wait_for_data(time_left)) {
+			return true;
+		}
+
+		auto const peek_result = socket.peek_available(peek_buffer);
+		if (!std::holds_alternative<std::size_t>(peek_result)) {
+			return false;
+		}
+		auto const peeked_data = utils::data_to_string(std::span{peek_buffer}.first(std::get<std::size_t>(peek_result)));
+
+		if (auto const is_continue_response = get_is_continue_response(peeked_data)) {
+			return *is_continue_response;
+		}
+		if (peeked_data.size() == peek_buffer.size()) {
+			return true;
+		}
+		// No more data is coming, and wait_for_data would return immediately from now on.
+		if (socket.get_is_closed_after_peeked_data()) {
+			return false;
+		}
+	}
+}
 
-	auto response_parser = algorithms::ResponseParser{callbacks};
+/*
+	Receives the response to a request that has been sent through socket.
+	url is the url of the request, which is shared with the returned Response.
+*/
+template<std::size_t buffer_size = std::size_t{1} << 12>
+[[nodiscard]]
+inline Response receive_response(
+	Socket const& socket, 
+	utils::SharedString const& url, 
+	ResponseCallbacks const& callbacks, 
+	ResponseParsingOptions const& parsing_options, 
+	std::chrono::steady_clock::time_point const start_time_point
+) {
+	auto response_parser = algorithms::ResponseParser{callbacks, parsing_options};
 
 	auto read_buffer = std::array<std::byte, buffer_size>();
 	
-	while (!has_stopped) {
-		if (auto const read_result = socket.read(read_buffer);
-			std::holds_alternative<std::size_t>(read_result))
+	// The parser returns the response when it is complete or has been stopped by a callback.
+	while (true) {
+		auto const read_result = socket.read(read_buffer);
+		auto const is_connection_closed = !std::holds_alternative<std::size_t>(read_result);
+
+		// Closing the connection ends the body of some responses.
+		if (auto parse_result = is_connection_closed ? 
+				response_parser.finish_at_connection_close() :
+				response_parser.parse_new_data(std::span{read_buffer}.first(std::get<std::size_t>(read_result))))
 		{
-			if (auto parse_result = response_parser.parse_new_data(
-					std::span{read_buffer}.first(std::get<std::size_t>(read_result))
-				))
-			{
-				// Calculate the total total duration
-				// Total time = End time - Start time
-				const auto end_time_point = std::chrono::steady_clock::now();
-				const std::chrono::duration<double, std::milli> total_time_duration = end_time_point - start_time_point;
-				// Create Response object
-				auto response = Response{std::move(*parse_result), std::move(url), std::move(total_time_duration)};
-				if (callbacks.handle_finish) {
-					callbacks.handle_finish(response);
-				}
-				return response;
+			// Calculate the total total duration
+			// Total time = End time - Start time
+			const auto end_time_point = std::chrono::steady_clock::now();
+			const std::chrono::duration<double, std::milli> total_time_duration = end_time_point - start_time_point;
+			// Create Response object
+			auto response = Response{std::move(*parse_result), url, total_time_duration};
+			if (callbacks.handle_finish) {
+				callbacks.handle_finish(response);
 			}
+			return response;
+		}
+		if (is_connection_closed) {
+			throw errors::ConnectionFailed{"The peer closed the connection unexpectedly"};
 		}
-		else throw errors::ConnectionFailed{"The peer closed the connection unexpectedly"};
 	}
-
-	utils::unreachable();
 }
 
 } // namespace algorithms
 
 //---------------------------------------------------------
 
+/*
+	A URL that has been checked and split into its components at compile time.
+	It is created with the _url literal, and converts to Url without any parsing.
+*/
+struct UrlLiteral {
+	std::string_view string;
+	utils::UrlPositions positions;
+};
+
+inline namespace literals {
+
+/*
+	Creates a URL at compile time, for example "https://api.example.com/v1/items"_url.
+	A URL with an unsupported protocol, an invalid port, no host or characters 
+	that would need to be URI-encoded is a compile error.
+*/
+template<utils::FixedString url>
+[[nodiscard]]
+consteval UrlLiteral operator""_url() {
+	constexpr auto string = url.view();
+
+	if (!std::ranges::all_of(string, utils::get_is_allowed_uri_character)) {
+		throw std::invalid_argument{"URL literals must not contain characters that need to be URI-encoded."};
+	}
+
+	auto const positions = utils::get_url_positions(string, Protocol::Http);
+	
+	if (string.find("://") != std::string_view::npos && utils::split_url(string).protocol == Protocol::Unknown) {
+		throw std::invalid_argument{"The protocol of the URL literal is not supported."};
+	}
+	if (positions.host_size == 0) {
+		throw std::invalid_argument{"The URL literal has no host."};
+	}
+	// Anything between the host and the path is the port.
+	if (auto const port_string = string.substr(positions.host_offset + positions.host_size, positions.path_offset - positions.host_offset - positions.host_size);
+		!port_string.empty() && !utils::parse_port(port_string.substr(1)))
+	{
+		throw std::invalid_argument{"The port of the URL literal is not valid."};
+	}
+
+	return UrlLiteral{string, positions};
+}
+
+} // namespace literals
+
+/*
+	A URL that is URI-encoded and split into its components once, so that it can be reused cheaply.
+	The components are stored as offsets into the URL string, so copies of a Url are independent.
+*/
+class Url {
+public:
+	/*
+		Returns the whole URI-encoded URL.
+	*/
+	[[nodiscard]]
+	std::pmr::string const& get_string() const& noexcept {
+		return string_;
+	}
+	[[nodiscard]]
+	std::pmr::string get_string() && noexcept {
+		return std::move(string_);
+	}
+	[[nodiscard]]
+	std::pmr::polymorphic_allocator<> get_allocator() const noexcept {
+		return string_.get_allocator();
+	}
+
+	[[nodiscard]]
+	Protocol get_protocol() const noexcept {
+		return positions_.protocol;
+	}
+	[[nodiscard]]
+	std::string_view get_host() const noexcept {
+		return std::string_view{string_}.substr(positions_.host_offset, positions_.host_size);
+	}
+	[[nodiscard]]
+	Port get_port() const noexcept {
+		return positions_.port;
+	}
+	/*
+		Returns the path of the URL, including any query and fragment.
+		It is "/" if the URL has no path.
+	*/
+	[[nodiscard]]
+	std::string_view get_path() const noexcept {
+		if (positions_.path_size == 0) {
+			return "/";
+		}
+		return std::string_view{string_}.substr(positions_.path_offset, positions_.path_size);
+	}
+	/*
+		Returns the components of the URL, which point into this Url object.
+	*/
+	[[nodiscard]]
+	utils::UrlComponents get_components() const noexcept {
+		return utils::UrlComponents{
+			.protocol = positions_.protocol,
+			.host = get_host(),
+			.port = positions_.port,
+			.path = get_path(),
+		};
+	}
+
+	/*
+		Adds a query parameter to the URL. The name and value are URI-encoded, 
+		so they can contain any characters.
+	*/
+	Url& add_query_parameter(std::string_view const name, std::string_view const value) & {
+		auto const path = std::string_view{string_}.substr(positions_.path_offset, positions_.path_size);
+		
+		// The query comes before any fragment.
+		auto const fragment_position = path.find('#');
+		auto const insert_position = fragment_position == std::string_view::npos ? path.size() : fragment_position;
+
+		auto parameter = std::pmr::string{string_.get_allocator()};
+		if (positions_.path_size == 0) {
+			parameter += '/';
+		}
+		parameter += path.substr(0, insert_position).find('?') == std::string_view::npos ? '?' : '&';
+		parameter += utils::uri_encode_component(name);
+		parameter += '=';
+		parameter += utils::uri_encode_component(value);
+
+		string_.insert(positions_.path_offset + insert_position, parameter);
+		positions_.path_size += parameter.size();
+		return *this;
+	}
+	/*
+		Adds a query parameter to the URL. The name and value are URI-encoded, 
+		so they can contain any characters.
+	*/
+	[[nodiscard]]
+	Url&& add_query_parameter(std::string_view const name, std::string_view const value) && {
+		add_query_parameter(name, value);
+		return std::move(*this);
+	}
+
+	[[nodiscard]]
+	bool operator==(Url const&) const noexcept = default;
+
+	/*
+		URI-encodes and splits url.
+		If url contains a protocol prefix, it is used. Otherwise, default_protocol is used.
+		If url contains no port, the default port of the protocol is used.
+	*/
+	explicit Url(std::string_view const url, Protocol const default_protocol = Protocol::Http) :
+		string_{std::string_view{utils::uri_encode(url)}},
+		positions_{utils::get_url_positions(string_, default_protocol)}
+	{}
+	/*
+		Creates a Url from a URL that was parsed at compile time, without parsing it again.
+	*/
+	Url(UrlLiteral const literal) :
+		string_{literal.string},
+		positions_{literal.positions}
+	{}
+	/*
+		Copies other into memory that is allocated with allocator.
+	*/
+	Url(Url const& other, std::pmr::polymorphic_allocator<> const allocator) :
+		string_{other.string_, allocator},
+		positions_{other.positions_}
+	{}
+
+	Url(Url const&) = default;
+	Url& operator=(Url const&) = default;
+	Url(Url&&) noexcept = default;
+	Url& operator=(Url&&) noexcept = default;
+
+private:
+	std::pmr::string string_;
+	utils::UrlPositions positions_;
+};
+
 /*
 	Enumeration of the different HTTP request methods that can be used.
 */
@@ -1701,6 +4105,92 @@ inline std::string_view request_method_to_string(RequestMethod const method) {
 	utils::unreachable();
 }
 
+/*
+	Passed to the upload progress callback of a request while its body is being sent.
+*/
+struct RequestProgressBody {
+	std::size_t body_size_so_far;
+	/*
+		This does not have a value if the body is streamed without a known size,
+		in which case it is sent with chunked transfer encoding.
+	*/
+	std::optional<std::size_t> total_expected_body_size;
+};
+
+namespace algorithms {
+
+/*
+	The maximum size of the pieces that a streamed request body is read from its body source in.
+*/
+inline constexpr auto body_stream_piece_size = std::size_t{1} << 14;
+
+/*
+	Reads a streamed request body from body_source and passes it to output, framed for sending.
+	If body_size has a value, the body is passed on as it is, and body_source must produce exactly 
+	that many bytes. Otherwise each piece of the body is passed on as a chunk of the chunked transfer 
+	encoding, and the body ends with the last chunk, "0\r\n\r\n". Each chunk is passed to output at once.
+	handle_progress is called with the number of body bytes that have been passed on after each piece.
+	std::length_error is thrown if body_source produces a different amount of data than body_size, 
+	or returns a size that is larger than the buffer it was given.
+*/
+inline void write_body_stream(
+	BodySource const& body_source, 
+	std::optional<std::size_t> const body_size, 
+	BodySink const& output, 
+	std::function<void(RequestProgressBody const&)> const& handle_progress = {}
+) {
+	// The chunk size in hexadecimal and CRLF is written before the chunk data, 
+	// and CRLF after it, so that each chunk can be passed on at once.
+	constexpr auto chunk_header_capacity = sizeof(std::size_t)*2 + 2;
+	auto buffer = std::array<std::byte, chunk_header_capacity + body_stream_piece_size + 2>();
+	auto const data_buffer = std::span{buffer}.subspan(chunk_header_capacity, body_stream_piece_size);
+
+	auto body_size_so_far = std::size_t{};
+	while (true) {
+		auto const size = body_source(data_buffer);
+		if (size > data_buffer.size()) {
+			throw std::length_error{"The body source returned a size that is larger than its buffer."};
+		}
+		body_size_so_far += size;
+
+		if (body_size) {
+			if (body_size_so_far > *body_size || (size == 0 && body_size_so_far < *body_size)) {
+				throw std::length_error{"The body source produced a different amount of data than the body size of the request."};
+			}
+			if (size == 0) {
+				break;
+			}
+			output(data_buffer.first(size));
+		}
+		else {
+			auto chunk_header = std::array<char, chunk_header_capacity>();
+			auto const chunk_size_end = std::to_chars(chunk_header.data(), chunk_header.data() + chunk_header.size(), size, 16).ptr;
+			auto const chunk_header_size = static_cast<std::size_t>(chunk_size_end - chunk_header.data()) + 2;
+			*chunk_size_end = '\r';
+			*(chunk_size_end + 1) = '\n';
+
+			auto const chunk_start = chunk_header_capacity - chunk_header_size;
+			std::ranges::copy(utils::string_to_data<std::byte>(std::string_view{chunk_header.data(), chunk_header_size}), buffer.begin() + static_cast<std::ptrdiff_t>(chunk_start));
+			buffer[chunk_header_capacity + size] = std::byte{'\r'};
+			buffer[chunk_header_capacity + size + 1] = std::byte{'\n'};
+
+			// The last chunk has a size of 0, which makes it "0\r\n\r\n".
+			output(std::span{buffer}.subspan(chunk_start, chunk_header_size + size + 2));
+			if (size == 0) {
+				break;
+			}
+		}
+
+		if (handle_progress) {
+			handle_progress(RequestProgressBody{body_size_so_far, body_size});
+		}
+	}
+}
+
+} // namespace algorithms
+
+class PreparedRequest;
+
 /*
 	Represents a HTTP request.
 	It is created by calling any of the HTTP verb functions (http_client::get, http_client::post, http_client::put ...)
@@ -1733,14 +4223,13 @@ public:
 	template<IsHeader Header_, std::size_t extent = std::dynamic_extent>
 	[[nodiscard]]
 	Request&& add_headers(std::span<Header_ const, extent> const headers) && {
-		auto headers_string = std::string{};
-		headers_string.reserve(headers.size()*128);
+		headers_.reserve(headers_.size() + headers.size()*128);
 		
 		for (auto const& header : headers) {
-			headers_string += std::format("{}: {}\r\n", header.name, header.value);
+			std::format_to(std::back_inserter(headers_), "{}: {}\r\n", header.name, header.value);
 		}
 		
-		return std::move(*this).add_headers(headers_string);
+		return std::move(*this);
 	}
 	/*
 		Adds headers to the request.
@@ -1759,13 +4248,28 @@ public:
 		auto const headers = std::array{Header{p_headers}...};
 		return std::move(*this).add_headers(std::span{headers});
 	}
+	/*
+		Adds headers that are known at compile time to the request, for example:
+		add_headers<"Accept: application/json", "User-Agent: service/1.0">()
+		The header block is built and validated at compile time, 
+		so a malformed header is a compile error.
+	*/
+	template<utils::FixedString ... header_lines>
+		requires (sizeof...(header_lines) > 0)
+	[[nodiscard]]
+	Request&& add_headers() && {
+		static constexpr auto header_block = utils::make_header_block<header_lines...>();
+		headers_.append(header_block.data(), header_block.size());
+		return std::move(*this);
+	}
 	/*
 		Adds a single header to the request.
 		Equivalent to add_headers with a single Header argument.
 	*/
 	[[nodiscard]]
 	Request&& add_header(Header const& header) && {
-		return std::move(*this).add_headers(std::format("{}: {}", header.name, header.value));
+		std::format_to(std::back_inserter(headers_), "{}: {}\r\n", header.name, header.value);
+		return std::move(*this);
 	}
 
 	/*
@@ -1774,14 +4278,14 @@ public:
 	template<utils::IsByte Byte_>
 	[[nodiscard]]
 	Request&& set_body(std::span<Byte_ const> const body_data) && {
-		body_.resize(body_data.size());
+		auto body = utils::pmr::DataVector(body_data.size(), headers_.get_allocator());
 		if constexpr (std::same_as<Byte_, std::byte>) {
-			std::ranges::copy(body_data, body_.begin());
+			std::ranges::copy(body_data, body.begin());
 		}
 		else {
-			std::ranges::copy(std::span{reinterpret_cast<std::byte const*>(body_data.data()), body_data.size()}, body_.begin());
+			std::ranges::copy(std::span{reinterpret_cast<std::byte const*>(body_data.data()), body_data.size()}, body.begin());
 		}
-		return std::move(*this);
+		return std::move(*this).set_body_(std::move(body));
 	}
 	/*
 		Sets the content of the request as a string view.
@@ -1790,22 +4294,207 @@ public:
 	Request&& set_body(std::string_view const body_data) && {
 		return std::move(*this).set_body(utils::string_to_data<std::byte>(body_data));
 	}
-
+	/*
+		Sets the content of the request as a sequence of bytes that is shared with other requests,
+		which avoids copying it when the same body is sent many times.
+		The data must not be modified until the request has been sent.
+	*/
 	[[nodiscard]]
-	Request&& set_raw_progress_callback(std::function<void(ResponseProgressRaw&)> callback) && {
-		callbacks_.handle_raw_progress = std::move(callback);
-		return std::move(*this);
+	Request&& set_body(std::shared_ptr<utils::DataVector const> body_data) && {
+		return std::move(*this).set_body_(std::move(body_data));
 	}
+	/*
+		Sets the content of the request as a sequence of bytes without copying it.
+		The data must stay valid and unmodified until send, send_to_file or send_async has returned.
+		If the request is prepared (see prepare), the data must instead outlive the PreparedRequest.
+	*/
+	template<utils::IsByte Byte_>
 	[[nodiscard]]
-	Request&& set_headers_callback(std::function<void(ResponseProgressHeaders&)> callback) && {
-		callbacks_.handle_headers = std::move(callback);
-		return std::move(*this);
+	Request&& set_body_view(std::span<Byte_ const> const body_data) && {
+		return std::move(*this).set_body_(std::span{reinterpret_cast<std::byte const*>(body_data.data()), body_data.size()});
 	}
-	[[nodiscard]]
+	/*
+		Sets the content of the request as a string without copying it.
+		The string must stay valid and unmodified until send, send_to_file or send_async has returned.
+		If the request is prepared (see prepare), the string must instead outlive the PreparedRequest.
+	*/
+	[[nodiscard]]
+	Request&& set_body_view(std::string_view const body_data) && {
+		return std::move(*this).set_body_view(utils::string_to_data<std::byte>(body_data));
+	}
+	/*
+		Sets the content of the request as a sequence of bytes that are compressed 
+		with a content encoding, and adds the corresponding Content-Encoding header.
+		See algorithms::ContentEncoder for the meaning of level and the errors that can be thrown.
+		Note that the server must support the content encoding.
+	*/
+	template<utils::IsByte Byte_>
+	[[nodiscard]]
+	Request&& set_body_compressed(std::span<Byte_ const> const body_data, ContentEncoding const encoding, std::optional<int> const level = {}) && {
+		auto encoder = algorithms::ContentEncoder{encoding, level};
+		auto body = utils::pmr::DataVector(headers_.get_allocator());
+		auto const output = algorithms::BodySink{[&body](std::span<std::byte const> const data) {
+			utils::append_to_vector(body, data);
+		}};
+		encoder.encode(std::span{reinterpret_cast<std::byte const*>(body_data.data()), body_data.size()}, output);
+		encoder.finish(output);
+
+		return std::move(*this).set_body_(std::move(body)).set_content_encoding_header_(encoding);
+	}
+	/*
+		Sets the content of the request as a string view that is compressed 
+		with a content encoding, and adds the corresponding Content-Encoding header.
+	*/
+	[[nodiscard]]
+	Request&& set_body_compressed(std::string_view const body_data, ContentEncoding const encoding, std::optional<int> const level = {}) && {
+		return std::move(*this).set_body_compressed(utils::string_to_data<std::byte>(body_data), encoding, level);
+	}
+	/*
+		Sets the content of the request to the data produced by body_source, compressed 
+		with a content encoding while the request is being sent, and adds the corresponding 
+		Content-Encoding header. Neither the uncompressed nor the compressed body is kept in memory 
+		as a whole. The compressed size is not known up front, so the body is sent with chunked 
+		transfer encoding. See set_body_stream and algorithms::make_compressing_body_source.
+	*/
+	[[nodiscard]]
+	Request&& set_body_compressed(algorithms::BodySource body_source, ContentEncoding const encoding, std::optional<int> const level = {}) && {
+		return std::move(*this)
+			.set_body_stream(algorithms::make_compressing_body_source(std::move(body_source), encoding, level))
+			.set_content_encoding_header_(encoding);
+	}
+	/*
+		Makes the content of the request be read from body_source while the request is being sent, 
+		so that the body never needs to be in memory as a whole. body_source is called repeatedly 
+		until it returns 0, which ends the body.
+		If body_size is given, the body is sent with a Content-Length header and body_source must 
+		produce exactly that many bytes, otherwise std::length_error is thrown.
+		If it is not given, the body is sent with chunked transfer encoding.
+	*/
+	[[nodiscard]]
+	Request&& set_body_stream(algorithms::BodySource body_source, std::optional<std::size_t> const body_size = {}) && {
+		body_ = {};
+		body_source_ = std::move(body_source);
+		body_source_size_ = body_size;
+		return std::move(*this);
+	}
+	/*
+		Sets a callback that is called each time a part of the request body has been sent.
+	*/
+	[[nodiscard]]
+	Request&& set_upload_progress_callback(std::function<void(RequestProgressBody const&)> callback) && {
+		handle_upload_progress_ = std::move(callback);
+		return std::move(*this);
+	}
+
+	[[nodiscard]]
+	Request&& set_raw_progress_callback(std::function<void(ResponseProgressRaw&)> callback) && {
+		callbacks_.handle_raw_progress = std::move(callback);
+		return std::move(*this);
+	}
+	[[nodiscard]]
+	Request&& set_headers_callback(std::function<void(ResponseProgressHeaders&)> callback) && {
+		callbacks_.handle_headers = std::move(callback);
+		return std::move(*this);
+	}
+	[[nodiscard]]
 	Request&& set_body_progress_callback(std::function<void(ResponseProgressBody&)> callback) && {
 		callbacks_.handle_body_progress = std::move(callback);
 		return std::move(*this);
 	}
+	/*
+		Makes the response body be passed to body_sink in slices as it is received,
+		instead of being accumulated in memory. The Response then only carries the 
+		status line and headers, and its body is empty. This is useful for bodies 
+		that are too big to be kept in memory.
+	*/
+	[[nodiscard]]
+	Request&& set_body_sink(algorithms::BodySink body_sink) && {
+		callbacks_.handle_body_data = std::move(body_sink);
+		return std::move(*this);
+	}
+	/*
+		Makes the response body be written to an output stream as it is received,
+		instead of being accumulated in memory. The stream must outlive the request.
+	*/
+	[[nodiscard]]
+	Request&& set_body_sink(std::ostream& stream) && {
+		return std::move(*this).set_body_sink([&stream](std::span<std::byte const> const data) {
+			stream.write(reinterpret_cast<char const*>(data.data()), static_cast<std::streamsize>(data.size()));
+		});
+	}
+	/*
+		Asks the server to compress the response body and decodes it while it is received.
+		This adds an Accept-Encoding header that lists the content encodings the library 
+		was built with support for, unless an Accept-Encoding header has already been added.
+		Body progress callbacks, body sinks and the Response then see the decoded body, 
+		and Response::get_encoded_body_size returns the size that was transferred.
+	*/
+	[[nodiscard]]
+	Request&& enable_content_decoding() && {
+		parsing_options_.is_decoding_content = true;
+		
+		if (!algorithms::find_header_value_in_string(headers_, "accept-encoding")) {
+			if (auto const accept_encoding = algorithms::get_accept_encoding_header_value(); !accept_encoding.empty()) {
+				return std::move(*this).add_header(Header{.name="Accept-Encoding", .value=accept_encoding});
+			}
+		}
+		return std::move(*this);
+	}
+	/*
+		Stores the response body in blocks of segment_size bytes instead of in one contiguous buffer,
+		so that receiving a large body never reallocates and copies the data received so far.
+		See Response::get_body_segments and Response::flatten_body.
+	*/
+	[[nodiscard]]
+	Request&& enable_segmented_body(std::size_t const segment_size = utils::SegmentedData::default_segment_size) && {
+		parsing_options_.body_segment_size = segment_size;
+		return std::move(*this);
+	}
+	/*
+		Only parses the response headers when they are first accessed, 
+		for requests whose response headers are usually not used.
+		See ResponseParsingOptions::is_parsing_headers_lazily.
+	*/
+	[[nodiscard]]
+	Request&& enable_lazy_header_parsing() && {
+		parsing_options_.is_parsing_headers_lazily = true;
+		return std::move(*this);
+	}
+	/*
+		Sends the request headers with "Expect: 100-continue" and waits for the server 
+		to respond before the body is sent, so that a large body is not uploaded only for the 
+		server to reject the request, for example with 401 Unauthorized or 413 Content Too Large.
+		The body is sent anyway if the server does not respond within timeout, 
+		since not all servers support the Expect header.
+		A server that does not support the expectation at all may instead respond with 
+		417 Expectation Failed, in which case the request is not retried automatically; 
+		send it again without calling enable_expect_continue.
+		Requests without a body are sent as usual.
+	*/
+	[[nodiscard]]
+	Request&& enable_expect_continue(std::chrono::milliseconds const timeout = std::chrono::seconds{1}) && {
+		expect_continue_timeout_ = timeout;
+		return std::move(*this);
+	}
+	/*
+		Allocates the request and everything that is used to receive the response, 
+		including the Response itself, from memory_resource instead of the default memory resource.
+		The url, headers and body that have already been given to the Request are moved into memory_resource, 
+		and the ones that are given to it afterwards are allocated from it directly.
+		Bodies that are shared (see set_body) or viewed (see set_body_view) are not copied.
+		memory_resource must outlive the Request and the Response.
+	*/
+	[[nodiscard]]
+	Request&& set_memory_resource(std::pmr::memory_resource* const memory_resource) && {
+		parsing_options_.memory_resource = memory_resource;
+		
+		utils::reconstruct(url_, Url{url_, memory_resource});
+		utils::reconstruct(headers_, std::pmr::string{headers_, memory_resource});
+		if (auto const owned_body = std::get_if<utils::pmr::DataVector>(&body_)) {
+			utils::reconstruct(body_, Body{utils::pmr::DataVector{*owned_body, memory_resource}});
+		}
+		return std::move(*this);
+	}
 	[[nodiscard]]
 	Request&& set_finish_callback(std::function<void(Response&)> callback) && {
 		callbacks_.handle_finish = std::move(callback);
@@ -1819,7 +4508,8 @@ public:
 		Sends the request and blocks until the response has been received.
 	*/
 	Response send() && {
-		return algorithms::receive_response<>(send_and_get_receive_socket_(), std::move(url_), std::move(callbacks_), std::move(start_time_point_));
+		auto socket = send_and_get_receive_socket_();
+		return algorithms::receive_response<>(socket, get_response_url_(), callbacks_, parsing_options_, start_time_point_);
 	}
 	/*
 		Sends the request and blocks until the response has been received.
@@ -1831,14 +4521,57 @@ public:
 	*/
 	template<std::size_t buffer_size>
 	Response send() && {
-		return algorithms::receive_response<buffer_size>(send_and_get_receive_socket_(), std::move(url_), std::move(callbacks_), std::move(start_time_point_));
+		auto socket = send_and_get_receive_socket_();
+		return algorithms::receive_response<buffer_size>(socket, get_response_url_(), callbacks_, parsing_options_, start_time_point_);
+	}
+	/*
+		Sends the request and blocks until the response has been received.
+		The response is received into storage that is reused from earlier responses, see ResponseBuffers.
+		See the other overloads of send for the meaning of buffer_size.
+	*/
+	template<std::size_t buffer_size = std::size_t{1} << 12>
+	Response send(ResponseBuffers& buffers) && {
+		parsing_options_.response_buffers = &buffers;
+		return std::move(*this).template send<buffer_size>();
+	}
+	/*
+		Sends the request and writes the response body to a file while it is being received,
+		so that memory usage stays constant regardless of the size of the body.
+		If the response has a Content-Length header, disk space for the file is reserved 
+		up front. The returned Response only carries the status line and headers.
+
+		The file is only created or truncated once a response with a 2xx status code has been received.
+		If the request fails or the status code is something else, an existing file is left as it is 
+		and the body of the response is discarded.
+	*/
+	Response send_to_file(std::string_view const file_path) && {
+		auto file = std::optional<utils::OutputFile>{};
+		set_file_sink_(file, file_path);
+		auto socket = send_and_get_receive_socket_();
+		return algorithms::receive_response<>(socket, get_response_url_(), callbacks_, parsing_options_, start_time_point_);
+	}
+	/*
+		Sends the request and writes the response body to a file while it is being received.
+		See the non-template overload of send_to_file for details.
+
+		The buffer_size template parameter specifies the size of the buffer that data
+		from the server is read into at a time. This is also the amount of data that
+		is written to the file at a time.
+	*/
+	template<std::size_t buffer_size>
+	Response send_to_file(std::string_view const file_path) && {
+		auto file = std::optional<utils::OutputFile>{};
+		set_file_sink_(file, file_path);
+		auto socket = send_and_get_receive_socket_();
+		return algorithms::receive_response<buffer_size>(socket, get_response_url_(), callbacks_, parsing_options_, start_time_point_);
 	}
 	/*
 		Sends the request and returns immediately after the data has been sent.
 		The returned future receives the response asynchronously.
 	*/
 	std::future<Response> send_async() && {
-		return std::async(&algorithms::receive_response<>, send_and_get_receive_socket_(), std::move(url_), std::move(callbacks_), std::move(start_time_point_));
+		auto socket = send_and_get_receive_socket_();
+		return std::async(&algorithms::receive_response<>, std::move(socket), get_response_url_(), std::move(callbacks_), std::move(parsing_options_), start_time_point_);
 	}
 	/*
 		Sends the request and returns immediately after the data has been sent.
@@ -1851,7 +4584,8 @@ public:
 	*/
 	template<std::size_t buffer_size>
 	std::future<Response> send_async() && {
-		return std::async(&algorithms::receive_response<buffer_size>, send_and_get_receive_socket_(), std::move(url_), std::move(callbacks_), std::move(start_time_point_));
+		auto socket = send_and_get_receive_socket_();
+		return std::async(&algorithms::receive_response<buffer_size>, std::move(socket), get_response_url_(), std::move(callbacks_), std::move(parsing_options_), start_time_point_);
 	}
 
 	Request() = delete;
@@ -1863,65 +4597,225 @@ public:
 	Request(Request const&) = delete;
 	Request& operator=(Request const&) = delete;
 
+	/*
+		Serializes the request in the same way as send does, without sending it.
+		Each piece of data that send writes to the server at once is passed to output in turn.
+		A streamed body (see set_body_stream) is read from its source, and upload progress 
+		is reported as the body is passed to output. If the request expects 100 Continue 
+		(see enable_expect_continue), the body is passed on as if the server asked for it.
+	*/
+	void serialize(algorithms::BodySink const& output) && {
+		write_request_(output, [] { return true; });
+	}
+
+	/*
+		Serializes the request line, headers and body once, so that the request 
+		can be sent many times cheaply. See PreparedRequest.
+		A request with a streamed body (see set_body_stream) can not be prepared, 
+		because the body can only be read once. std::logic_error is thrown then.
+		A body that was set with set_body_view is not copied, so its data must outlive the PreparedRequest.
+	*/
+	[[nodiscard]]
+	PreparedRequest prepare() &&;
+
 private:
+	friend class PreparedRequest;
+
+	using Body = std::variant<utils::pmr::DataVector, std::span<std::byte const>, std::shared_ptr<utils::DataVector const>>;
+
+	[[nodiscard]]
+	Request&& set_body_(Body&& body) && {
+		body_source_ = {};
+		utils::reconstruct(body_, std::move(body));
+		return std::move(*this);
+	}
+	/*
+		Returns the body data, regardless of whether it is owned, borrowed or shared.
+	*/
+	[[nodiscard]]
+	std::span<std::byte const> get_body_() const {
+		if (auto const shared_body = std::get_if<std::shared_ptr<utils::DataVector const>>(&body_)) {
+			return *shared_body ? std::span{**shared_body} : std::span<std::byte const>{};
+		}
+		else if (auto const borrowed_body = std::get_if<std::span<std::byte const>>(&body_)) {
+			return *borrowed_body;
+		}
+		return std::get<utils::pmr::DataVector>(body_);
+	}
+
+	[[nodiscard]]
+	utils::SharedString get_response_url_() const {
+		return utils::SharedString{url_.get_string(), parsing_options_.get_memory_resource()};
+	}
+
+	/*
+		Adds a Content-Encoding header, replacing any that was added before, 
+		so that a body that is set again is not described as being encoded twice.
+	*/
+	[[nodiscard]]
+	Request&& set_content_encoding_header_(ContentEncoding const encoding) && {
+		algorithms::remove_header_lines_from_string(headers_, "content-encoding");
+		return std::move(*this).add_header(Header{.name="Content-Encoding", .value=content_encoding_to_string(encoding)});
+	}
+
+	/*
+		Makes the response body be written to a file at file_path if the response is successful.
+		The file is opened into file when the headers have been received, 
+		and space is reserved for it if the size is known.
+	*/
+	void set_file_sink_(std::optional<utils::OutputFile>& file, std::string_view const file_path) {
+		callbacks_.handle_headers = [&file, file_path, handle_headers = std::move(callbacks_.handle_headers), is_decoding_content = parsing_options_.is_decoding_content]
+			(ResponseProgressHeaders& progress) 
+		{
+			if (handle_headers) {
+				handle_headers(progress);
+			}
+			if (static_cast<int>(progress.get_status_code())/100 != 2) {
+				return;
+			}
+			file.emplace(file_path);
+			// The size of a content encoded body is not the size of the file.
+			if (is_decoding_content && progress.get_header_value(KnownHeader::ContentEncoding)) {
+				return;
+			}
+			if (auto const content_length = progress.get_header_value(KnownHeader::ContentLength)) {
+				if (auto const size = utils::string_to_integral<std::uint64_t>(*content_length)) {
+					file->preallocate(*size);
+				}
+			}
+		};
+		callbacks_.handle_body_data = [&file](std::span<std::byte const> const data) {
+			if (file) {
+				file->write(data);
+			}
+		};
+	}
+
 	[[nodiscard]]
 	Socket send_and_get_receive_socket_() {
 		// Start duration time measurement
 		start_time_point_ = std::chrono::steady_clock::now();
 
-		auto socket = open_socket(url_components_.host, url_components_.port, utils::is_protocol_tls_encrypted(url_components_.protocol));
+		auto socket = open_socket(url_.get_host(), url_.get_port(), utils::is_protocol_tls_encrypted(url_.get_protocol()));
 		
+		write_request_(
+			[&socket](std::span<std::byte const> const data) { socket.write(data); },
+			[this, &socket] { return algorithms::wait_for_continue(socket, *expect_continue_timeout_); }
+		);
+		return socket;
+	}
+
+	/*
+		Passes the request to output in the pieces that it is sent in.
+		If the request expects 100 Continue, get_is_body_wanted is called after the headers 
+		have been written, and the body is only written if it returns true.
+	*/
+	template<typename GetIsBodyWanted_>
+	void write_request_(algorithms::BodySink const& output, GetIsBodyWanted_ const& get_is_body_wanted) {
 		using namespace std::string_view_literals;
 
-		if (!body_.empty()) {
-			headers_ += std::format("Transfer-Encoding: identity\r\nContent-Length: {}\r\n", body_.size());
+		if (body_source_) {
+			if (body_source_size_) {
+				std::format_to(std::back_inserter(headers_), "Content-Length: {}\r\n", *body_source_size_);
+			}
+			else {
+				headers_ += "Transfer-Encoding: chunked\r\n";
+			}
+		}
+
+		auto const body = get_body_();
+		if (!body.empty()) {
+			std::format_to(std::back_inserter(headers_), "Transfer-Encoding: identity\r\nContent-Length: {}\r\n", body.size());
+		}
+
+		auto const is_expecting_continue = expect_continue_timeout_ && (body_source_ || !body.empty());
+		if (is_expecting_continue) {
+			headers_ += "Expect: 100-continue\r\n";
 		}
+
+		// Small bodies are sent together with the headers. Bigger bodies are written 
+		// directly from where they are stored instead of being copied, and so are 
+		// bodies whose progress is reported.
+		auto const is_body_in_request_data = !body_source_ && !handle_upload_progress_ && !is_expecting_continue && body.size() <= body_write_size;
 		
 		auto const request_data = utils::concatenate_byte_data(
+			std::allocator_arg, parsing_options_.get_memory_resource(),
 			request_method_to_string(method_),
 			' ',
-			url_components_.path,
+			url_.get_path(),
 			" HTTP/1.1\r\nHost: "sv,
-			url_components_.host,
+			url_.get_host(),
 			headers_,
 			"\r\n"sv,
-			body_
+			is_body_in_request_data ? body : std::span<std::byte const>{}
 		);
-		socket.write(request_data);
+		output(request_data);
 
-		return socket;
+		if (is_expecting_continue && !get_is_body_wanted()) {
+			// The server has already responded, so the body is not wanted.
+			return;
+		}
+
+		if (body_source_) {
+			algorithms::write_body_stream(body_source_, body_source_size_, output, handle_upload_progress_);
+		}
+		else if (!is_body_in_request_data) {
+			write_body_(output, body, handle_upload_progress_);
+		}
+	}
+
+	static constexpr auto body_write_size = std::size_t{1} << 14;
+
+	static void write_body_(
+		algorithms::BodySink const& output, 
+		std::span<std::byte const> const body, 
+		std::function<void(RequestProgressBody const&)> const& handle_upload_progress
+	) {
+		if (!handle_upload_progress) {
+			output(body);
+			return;
+		}
+		auto body_size_so_far = std::size_t{};
+		while (body_size_so_far < body.size()) {
+			auto const part = body.subspan(body_size_so_far).first(std::min(body_write_size, body.size() - body_size_so_far));
+			output(part);
+			body_size_so_far += part.size();
+			handle_upload_progress(RequestProgressBody{body_size_so_far, body.size()});
+		}
 	}
 
 	RequestMethod method_;
 
-	std::string url_;
-	utils::UrlComponents url_components_;
+	Url url_;
+
+	// These are allocated from parsing_options_.memory_resource, see set_memory_resource.
+	std::pmr::string headers_{"\r\n"};
+	Body body_;
 
-	std::string headers_{"\r\n"};
-	utils::DataVector body_;
+	algorithms::BodySource body_source_;
+	std::optional<std::size_t> body_source_size_;
+	std::function<void(RequestProgressBody const&)> handle_upload_progress_;
+	std::optional<std::chrono::milliseconds> expect_continue_timeout_;
 
 	algorithms::ResponseCallbacks callbacks_;
+	algorithms::ResponseParsingOptions parsing_options_;
 
 	std::chrono::steady_clock::time_point start_time_point_;
 
-	Request(RequestMethod const method, std::string_view const url, Protocol const default_protocol) :
+	Request(RequestMethod const method, Url url) :
 		method_{method},
-		url_{utils::uri_encode(url)},
-		url_components_{utils::split_url(std::string_view{url_})}
+		url_{std::move(url)}
 	{
-		if (url_components_.protocol == Protocol::Unknown) 
-		{
-			url_components_.protocol = default_protocol;
-		}
-		if (url_components_.port == utils::default_port_for_protocol(Protocol::Unknown))
-		{
-			url_components_.port = utils::default_port_for_protocol(url_components_.protocol);
-		}
+		parsing_options_.is_response_to_head_request = method == RequestMethod::Head;
 	}
 	friend Request get(std::string_view, Protocol);
 	friend Request post(std::string_view, Protocol);
 	friend Request put(std::string_view, Protocol);
 	friend Request make_request(RequestMethod, std::string_view, Protocol);
+	friend Request get(Url);
+	friend Request post(Url);
+	friend Request put(Url);
+	friend Request make_request(RequestMethod, Url);
 };
 
 /*
@@ -1931,7 +4825,14 @@ private:
 */
 [[nodiscard]] 
 inline Request get(std::string_view const url, Protocol const default_protocol = Protocol::Http) {
-	return Request{RequestMethod::Get, url, default_protocol};
+	return Request{RequestMethod::Get, Url{url, default_protocol}};
+}
+/*
+	Creates a GET request to a URL that has already been parsed.
+*/
+[[nodiscard]]
+inline Request get(Url url) {
+	return Request{RequestMethod::Get, std::move(url)};
 }
 
 /*
@@ -1941,7 +4842,14 @@ inline Request get(std::string_view const url, Protocol const default_protocol =
 */
 [[nodiscard]]
 inline Request post(std::string_view const url, Protocol const default_protocol = Protocol::Http) {
-	return Request{RequestMethod::Post, url, default_protocol};
+	return Request{RequestMethod::Post, Url{url, default_protocol}};
+}
+/*
+	Creates a POST request to a URL that has already been parsed.
+*/
+[[nodiscard]]
+inline Request post(Url url) {
+	return Request{RequestMethod::Post, std::move(url)};
 }
 
 /*
@@ -1951,7 +4859,14 @@ inline Request post(std::string_view const url, Protocol const default_protocol
 */
 [[nodiscard]]
 inline Request put(std::string_view const url, Protocol const default_protocol = Protocol::Http) {
-	return Request{RequestMethod::Put, url, default_protocol};
+	return Request{RequestMethod::Put, Url{url, default_protocol}};
+}
+/*
+	Creates a PUT request to a URL that has already been parsed.
+*/
+[[nodiscard]]
+inline Request put(Url url) {
+	return Request{RequestMethod::Put, std::move(url)};
 }
 
 /*
@@ -1965,7 +4880,681 @@ inline Request make_request(
 	std::string_view const url, 
 	Protocol const default_protocol = Protocol::Http
 ) {
-	return Request{method, url, default_protocol};
+	return Request{method, Url{url, default_protocol}};
+}
+/*
+	Creates a http request to a URL that has already been parsed.
+*/
+[[nodiscard]]
+inline Request make_request(RequestMethod const method, Url url) {
+	return Request{method, std::move(url)};
+}
+
+/*
+	A request that has been serialized once so that it can be sent many times,
+	for example when polling a resource. It is created by Request::prepare.
+	Each send can add headers and replace the body, and only those parts are serialized again.
+	Each send opens a new connection to the server.
+*/
+class PreparedRequest {
+public:
+	/*
+		Sends the request and blocks until the response has been received.
+		extra_headers are sent after the prepared headers. 
+		If body has a value, it is sent instead of the prepared body.
+
+		The buffer_size template parameter specifies the size of the buffer that data
+		from the server is read into at a time. See Request::send.
+	*/
+	template<std::size_t buffer_size = std::size_t{1} << 12>
+	Response send(
+		std::span<Header const> const extra_headers = {}, 
+		std::optional<std::span<std::byte const>> const body = {}
+	) const {
+		auto const start_time_point = std::chrono::steady_clock::now();
+		return algorithms::receive_response<buffer_size>(
+			send_and_get_receive_socket_(extra_headers, body), 
+			response_url_, *callbacks_, parsing_options_, start_time_point
+		);
+	}
+	/*
+		Sends the request and blocks until the response has been received.
+		The response is received into storage that is reused from earlier responses, see ResponseBuffers.
+		See the other overload of send for the meaning of the other parameters.
+	*/
+	template<std::size_t buffer_size = std::size_t{1} << 12>
+	Response send(
+		ResponseBuffers& buffers,
+		std::span<Header const> const extra_headers = {}, 
+		std::optional<std::span<std::byte const>> const body = {}
+	) const {
+		auto const start_time_point = std::chrono::steady_clock::now();
+		auto parsing_options = parsing_options_;
+		parsing_options.response_buffers = &buffers;
+		return algorithms::receive_response<buffer_size>(
+			send_and_get_receive_socket_(extra_headers, body), 
+			response_url_, *callbacks_, parsing_options, start_time_point
+		);
+	}
+	/*
+		Sends the request and returns immediately after the data has been sent.
+		The returned future receives the response asynchronously.
+		See the send function for the meaning of the parameters.
+	*/
+	template<std::size_t buffer_size = std::size_t{1} << 12>
+	std::future<Response> send_async(
+		std::span<Header const> const extra_headers = {}, 
+		std::optional<std::span<std::byte const>> const body = {}
+	) const {
+		auto const start_time_point = std::chrono::steady_clock::now();
+		return std::async(
+			// The callbacks are shared instead of copied, and outlive the PreparedRequest if needed.
+			[socket = send_and_get_receive_socket_(extra_headers, body), url = response_url_, callbacks = callbacks_, 
+				parsing_options = parsing_options_, start_time_point]
+			{
+				return algorithms::receive_response<buffer_size>(socket, url, *callbacks, parsing_options, start_time_point);
+			}
+		);
+	}
+
+	/*
+		Serializes the request in the same way as send does for the same arguments, without sending it.
+		Each piece of data that send writes to the server at once is passed to output in turn: 
+		first the request line and headers, which the body is part of if it is small, 
+		and then the body if it is not.
+	*/
+	void serialize(
+		algorithms::BodySink const& output,
+		std::span<Header const> const extra_headers = {}, 
+		std::optional<std::span<std::byte const>> const body = {}
+	) const {
+		write_request_(extra_headers, body, output, output);
+	}
+
+	[[nodiscard]]
+	Url const& get_url() const noexcept {
+		return url_;
+	}
+
+	PreparedRequest() = delete;
+	~PreparedRequest() = default;
+
+	PreparedRequest(PreparedRequest const&) = default;
+	PreparedRequest& operator=(PreparedRequest const&) = default;
+
+	PreparedRequest(PreparedRequest&&) noexcept = default;
+	PreparedRequest& operator=(PreparedRequest&&) noexcept = default;
+
+private:
+	[[nodiscard]]
+	Socket send_and_get_receive_socket_(
+		std::span<Header const> const extra_headers, 
+		std::optional<std::span<std::byte const>> const body_override
+	) const {
+		auto socket = open_socket(url_.get_host(), url_.get_port(), utils::is_protocol_tls_encrypted(url_.get_protocol()));
+
+		write_request_(
+			extra_headers, body_override,
+			[&socket](std::span<std::byte const> const data) { socket.write(data); },
+			[&](std::span<std::byte const> const body) {
+				if (get_is_body_wanted_(socket, body.size())) {
+					Request::write_body_(
+						[&socket](std::span<std::byte const> const data) { socket.write(data); }, 
+						body, handle_upload_progress_
+					);
+				}
+			}
+		);
+		return socket;
+	}
+
+	/*
+		Passes the request line, headers and the body if it is small to write_head, 
+		and then the body to write_body if it was not passed to write_head.
+	*/
+	template<typename WriteHead_, typename WriteBody_>
+	void write_request_(
+		std::span<Header const> const extra_headers, 
+		std::optional<std::span<std::byte const>> const body_override,
+		WriteHead_ const& write_head,
+		WriteBody_ const& write_body
+	) const {
+		if (extra_headers.empty() && !body_override) {
+			write_head(utils::string_to_data<std::byte>(std::string_view{request_data_}));
+			if (!is_body_in_request_data_) {
+				write_body(body_);
+			}
+			return;
+		}
+
+		auto const body = body_override.value_or(body_);
+		auto const is_body_in_request_data = get_is_body_in_request_data_(body.size());
+
+		auto request_data = std::pmr::string{parsing_options_.get_memory_resource()};
+		request_data.reserve(head_.size() + extra_headers.size()*64 + 64 + (is_body_in_request_data ? body.size() : 0));
+		request_data += head_;
+		for (auto const& header : extra_headers) {
+			((request_data += header.name) += ": ") += header.value;
+			request_data += "\r\n";
+		}
+		append_body_headers_(request_data, body.size());
+		request_data += "\r\n";
+		if (is_body_in_request_data) {
+			request_data += utils::data_to_string(body);
+		}
+		write_head(utils::string_to_data<std::byte>(std::string_view{request_data}));
+
+		if (!is_body_in_request_data) {
+			write_body(body);
+		}
+	}
+
+	[[nodiscard]]
+	bool get_is_expecting_continue_(std::size_t const body_size) const noexcept {
+		return expect_continue_timeout_ && body_size > 0;
+	}
+	/*
+		Small bodies are sent together with the headers, unless the server is asked 
+		whether it wants the body first. See Request::send_and_get_receive_socket_.
+	*/
+	[[nodiscard]]
+	bool get_is_body_in_request_data_(std::size_t const body_size) const noexcept {
+		return !handle_upload_progress_ && !get_is_expecting_continue_(body_size) && body_size <= Request::body_write_size;
+	}
+	/*
+		Waits for the server to ask for the body, if the request expects 100 Continue.
+	*/
+	[[nodiscard]]
+	bool get_is_body_wanted_(Socket const& socket, std::size_t const body_size) const {
+		return !get_is_expecting_continue_(body_size) || algorithms::wait_for_continue(socket, *expect_continue_timeout_);
+	}
+
+	template<typename String_>
+	void append_body_headers_(String_& request_data, std::size_t const body_size) const {
+		if (body_size > 0) {
+			std::format_to(std::back_inserter(request_data), "Transfer-Encoding: identity\r\nContent-Length: {}\r\n", body_size);
+		}
+		if (get_is_expecting_continue_(body_size)) {
+			request_data += "Expect: 100-continue\r\n";
+		}
+	}
+
+	Url url_;
+	// The url that is given to each response, which shares it instead of copying it.
+	utils::SharedString response_url_;
+
+	// The request line and headers, except for the headers that describe the body.
+	std::string head_;
+	
+	// Owns the data of body_ if it is not a view, which is either a utils::DataVector or a utils::pmr::DataVector.
+	std::shared_ptr<void const> body_owner_;
+	std::span<std::byte const> body_;
+
+	// The whole request with the prepared body, or without it if it is big.
+	std::string request_data_;
+	bool is_body_in_request_data_;
+
+	// The callbacks are shared by all sends instead of being copied for each of them.
+	std::shared_ptr<algorithms::ResponseCallbacks const> callbacks_;
+	algorithms::ResponseParsingOptions parsing_options_;
+	std::function<void(RequestProgressBody const&)> handle_upload_progress_;
+	std::optional<std::chrono::milliseconds> expect_continue_timeout_;
+
+	explicit PreparedRequest(Request&& request) :
+		url_{std::move(request.url_)},
+		response_url_{url_.get_string(), request.parsing_options_.get_memory_resource()},
+		head_{std::format(
+			"{} {} HTTP/1.1\r\nHost: {}{}", 
+			request_method_to_string(request.method_), url_.get_path(), url_.get_host(), std::string_view{request.headers_}
+		)},
+		callbacks_{std::make_shared<algorithms::ResponseCallbacks const>(std::move(request.callbacks_))},
+		parsing_options_{request.parsing_options_},
+		handle_upload_progress_{std::move(request.handle_upload_progress_)},
+		expect_continue_timeout_{request.expect_continue_timeout_}
+	{
+		if (auto const owned_body = std::get_if<utils::pmr::DataVector>(&request.body_)) {
+			auto body = std::make_shared<utils::pmr::DataVector const>(std::move(*owned_body));
+			body_ = *body;
+			body_owner_ = std::move(body);
+		}
+		else if (auto const shared_body = std::get_if<std::shared_ptr<utils::DataVector const>>(&request.body_)) {
+			body_ = *shared_body ? std::span{**shared_body} : std::span<std::byte const>{};
+			body_owner_ = std::move(*shared_body);
+		}
+		else {
+			// The data of a body view is not owned, see Request::set_body_view.
+			body_ = std::get<std::span<std::byte const>>(request.body_);
+		}
+
+		is_body_in_request_data_ = get_is_body_in_request_data_(body_.size());
+
+		request_data_ = head_;
+		append_body_headers_(request_data_, body_.size());
+		request_data_ += "\r\n";
+		if (is_body_in_request_data_) {
+			request_data_ += utils::data_to_string(body_);
+		}
+	}
+	friend class Request;
+};
+
+inline PreparedRequest Request::prepare() && {
+	if (body_source_) {
+		throw std::logic_error{"A request with a streamed body can not be prepared."};
+	}
+	return PreparedRequest{std::move(*this)};
+}
+
+//---------------------------------------------------------
+
+/*
+	Options for download_file_parallel.
+*/
+struct ParallelDownloadOptions {
+	/*
+		The maximum number of connections that byte ranges of the resource are downloaded through concurrently.
+	*/
+	std::size_t number_of_connections{4};
+	/*
+		The number of times the download of a single byte range is attempted before giving up.
+		Each new attempt continues where the previous one stopped.
+	*/
+	std::size_t max_attempts_per_range{3};
+	/*
+		Headers that are sent with every request, for example for authorization.
+	*/
+	std::vector<HeaderCopy> headers;
+	Protocol default_protocol{Protocol::Http};
+};
+
+namespace algorithms {
+
+/*
+	Downloads a byte range of a resource and writes it at the same position in a file.
+	If the download fails, it is retried from where it stopped until options.max_attempts_per_range
+	attempts have been made, after which the last errors::ConnectionFailed is rethrown.
+*/
+inline void download_byte_range(
+	std::string_view const url, 
+	utils::OutputFile& file, 
+	ByteRange const range, 
+	ParallelDownloadOptions const& options
+) {
+	auto next_byte = range.first;
+
+	for (auto attempt = std::size_t{1};; ++attempt) 
+	{
+		try {
+			auto is_unexpected_response = false;
+
+			[[maybe_unused]]
+			auto const response = make_request(RequestMethod::Get, url, options.default_protocol)
+				.add_headers(std::span{options.headers})
+				.add_header({.name="Range", .value=byte_range_to_range_header_value({.first = next_byte, .last = range.last})})
+				.set_headers_callback([&](ResponseProgressHeaders& headers) {
+					auto const content_range = headers.get_content_range();
+					if (headers.get_status_code() != StatusCode::PartialContent || 
+						!content_range || !content_range->range || content_range->range->first != next_byte)
+					{
+						is_unexpected_response = true;
+						headers.stop();
+					}
+				})
+				.set_body_sink([&](std::span<std::byte const> data) {
+					if (range.last) {
+						data = data.first(static_cast<std::size_t>(std::min<std::uint64_t>(data.size(), *range.last + 1 - next_byte)));
+					}
+					file.write_at(data, next_byte);
+					next_byte += data.size();
+				})
+				.send();
+
+			if (is_unexpected_response) {
+				throw errors::ConnectionFailed{std::format("The server did not respond with the requested byte range {}", 
+					byte_range_to_range_header_value({.first = next_byte, .last = range.last}))};
+			}
+			if (!range.last || next_byte > *range.last) {
+				return;
+			}
+			throw errors::ConnectionFailed{"The byte range response ended before the whole range was received"};
+		}
+		catch (errors::ConnectionFailed const&) {
+			if (attempt >= options.max_attempts_per_range) {
+				throw;
+			}
+		}
+	}
+}
+
+} // namespace algorithms
+
+/*
+	Downloads a resource into a file through several connections concurrently, which can give 
+	a higher throughput than a single connection for large files.
+
+	The first byte of the resource is requested first, to learn its size and whether the 
+	server supports byte range requests. If it does not, the whole resource is received through 
+	that first connection. Otherwise, the rest of the resource is split into byte ranges that 
+	are downloaded concurrently and written at their positions in the file. Disk space for the 
+	file is reserved up front.
+
+	The returned Response is the response to the first request, without any body. 
+	The file is only created or truncated once that response has a status code of 200 (OK) or 
+	206 (Partial Content). If the status code is something else, or the first request fails, 
+	an existing file is left as it is.
+	If the server responds with a byte range other than the requested one, 
+	or a byte range could not be downloaded, errors::ConnectionFailed is thrown.
+*/
+inline Response download_file_parallel(
+	std::string_view const url, 
+	std::string_view const file_path, 
+	ParallelDownloadOptions const& options = {}
+) {
+	// The file is opened once the response to the first request turns out to contain the resource.
+	auto file = std::optional<utils::OutputFile>{};
+
+	auto complete_length = std::optional<std::uint64_t>{};
+	auto bytes_received = std::uint64_t{};
+	auto is_unexpected_range = false;
+
+	auto response = make_request(RequestMethod::Get, url, options.default_protocol)
+		.add_headers(std::span{options.headers})
+		.add_header({.name="Range", .value=algorithms::byte_range_to_range_header_value({.first = 0, .last = 0})})
+		.set_headers_callback([&](ResponseProgressHeaders& headers) {
+			if (headers.get_status_code() == StatusCode::PartialContent) {
+				auto const content_range = headers.get_content_range();
+				if (!content_range || !content_range->range || content_range->range->first != 0) {
+					// Don't write another byte range at the start of the file.
+					is_unexpected_range = true;
+					headers.stop();
+					return;
+				}
+				complete_length = content_range->complete_length;
+			}
+			else if (headers.get_status_code() == StatusCode::Ok) {
+				if (auto const content_length = headers.get_header_value(KnownHeader::ContentLength)) {
+					complete_length = utils::string_to_integral<std::uint64_t>(*content_length);
+				}
+			}
+			else {
+				// Don't write an error page to the file, and leave an existing file alone.
+				headers.stop();
+				return;
+			}
+			file.emplace(file_path);
+			if (complete_length) {
+				file->preallocate(*complete_length);
+			}
+		})
+		.set_body_sink([&](std::span<std::byte const> const data) {
+			file->write_at(data, bytes_received);
+			bytes_received += data.size();
+		})
+		.send();
+
+	if (is_unexpected_range) {
+		throw errors::ConnectionFailed{std::format("The server did not respond with the requested byte range {}", 
+			algorithms::byte_range_to_range_header_value({.first = 0, .last = 0}))};
+	}
+	if (response.get_status_code() != StatusCode::PartialContent || 
+		(complete_length && bytes_received >= *complete_length)) 
+	{
+		return response;
+	}
+
+	auto downloads = std::vector<std::future<void>>();
+	
+	if (!complete_length) {
+		// The size of the resource is not known, so it can't be split up.
+		downloads.push_back(std::async(std::launch::async, &algorithms::download_byte_range, 
+			url, std::ref(*file), algorithms::ByteRange{.first = bytes_received, .last{}}, std::cref(options)));
+	}
+	else {
+		auto const bytes_left = *complete_length - bytes_received;
+		auto const number_of_ranges = std::min<std::uint64_t>(std::max(options.number_of_connections, std::size_t{1}), bytes_left);
+		auto const range_size = (bytes_left + number_of_ranges - 1) / number_of_ranges;
+
+		for (auto range_start = bytes_received; range_start < *complete_length; range_start += range_size) {
+			downloads.push_back(std::async(std::launch::async, &algorithms::download_byte_range, 
+				url, std::ref(*file), algorithms::ByteRange{
+					.first = range_start, 
+					.last = std::min(range_start + range_size, *complete_length) - 1
+				}, std::cref(options)));
+		}
+	}
+
+	// If one of the downloads fails, the destructors of the 
+	// other futures wait for them to finish before the file is closed.
+	for (auto& download : downloads) {
+		download.get();
+	}
+
+	return response;
+}
+
+//---------------------------------------------------------
+
+/*
+	Options for download_file_resumable.
+*/
+struct ResumableDownloadOptions {
+	/*
+		The number of times the download is attempted before giving up.
+		Each new attempt continues where the previous one stopped.
+	*/
+	std::size_t max_attempts{3};
+	/*
+		Headers that are sent with every request, for example for authorization.
+	*/
+	std::vector<HeaderCopy> headers;
+	Protocol default_protocol{Protocol::Http};
+};
+
+namespace algorithms {
+
+/*
+	Returns the path of the file that stores the state of a resumable download, next to the partial file.
+*/
+[[nodiscard]]
+inline std::string get_download_state_file_path(std::string_view const file_path) {
+	return std::string{file_path} + ".resume";
+}
+
+/*
+	Returns the value that should be sent in an If-Range header to resume a download of the resource 
+	that the response is for, or nothing if the resource can't be validated. Weak entity tags can't be used.
+*/
+[[nodiscard]]
+inline std::optional<std::string_view> get_if_range_validator(ParsedHeadersInterface const& response) {
+	if (auto const entity_tag = response.get_header_value(KnownHeader::ETag); entity_tag && !entity_tag->starts_with("W/")) {
+		return entity_tag;
+	}
+	return response.get_header_value(KnownHeader::LastModified);
+}
+
+/*
+	Returns the contents of the state file of a resumable download, 
+	for a resource that is validated with the value of an If-Range header.
+*/
+[[nodiscard]]
+inline std::string download_state_to_string(std::string_view const if_range_validator) {
+	return std::format("If-Range: {}\n", if_range_validator);
+}
+
+/*
+	Parses the contents of the state file of a resumable download, see download_state_to_string.
+	Returns the If-Range header that resumes the download, or nothing if the state is not valid.
+	The returned header points into state.
+*/
+[[nodiscard]]
+constexpr std::optional<Header> parse_download_state(std::string_view const state) {
+	if (auto const if_range = parse_header(state.substr(0, state.find('\n'))); 
+		if_range && utils::equal_ascii_case_insensitive(if_range->name, "if-range"))
+	{
+		return if_range;
+	}
+	return {};
+}
+
+/*
+	What a resumable download does with the partial file when the headers of a response have been received.
+*/
+enum class ResumableDownloadAction {
+	// The whole resource is sent, so the file is written from the start.
+	Restart,
+	// The missing bytes are sent, so they are appended to the file.
+	Append,
+	// The file already contains the whole resource, and the response has no body.
+	Complete,
+	// The server sent a different byte range than the one that was requested. The file is left as it is.
+	RangeMismatch,
+	// The response is not a successful one. The file is left as it is.
+	Fail,
+};
+
+/*
+	Decides what to do with a response to a request for the rest of a resource, 
+	of which bytes_downloaded bytes have already been downloaded.
+	If bytes_downloaded is 0, the whole resource was requested without a Range header.
+*/
+[[nodiscard]]
+constexpr ResumableDownloadAction get_resumable_download_action(
+	StatusCode const status_code, 
+	std::optional<ContentRange> const& content_range, 
+	std::uint64_t const bytes_downloaded
+) noexcept {
+	switch (status_code) {
+		case StatusCode::Ok:
+			// Either the download had not started, or the resource has changed since then.
+			return ResumableDownloadAction::Restart;
+		case StatusCode::PartialContent:
+			if (bytes_downloaded > 0 && content_range && content_range->range && content_range->range->first == bytes_downloaded) {
+				return ResumableDownloadAction::Append;
+			}
+			return ResumableDownloadAction::RangeMismatch;
+		case StatusCode::RangeNotSatisfiable:
+			if (bytes_downloaded > 0 && content_range && content_range->complete_length == bytes_downloaded) {
+				return ResumableDownloadAction::Complete;
+			}
+			return ResumableDownloadAction::Fail;
+		default:
+			return ResumableDownloadAction::Fail;
+	}
+}
+
+/*
+	Makes one attempt at downloading the rest of a resource.
+	The state file contains an If-Range header with the validator of the resource that is partially downloaded.
+	The size of the partial file is the number of bytes that have already been downloaded.
+	errors::ResponseParsingFailed is thrown if the server sends a different byte range than was requested.
+*/
+[[nodiscard]]
+inline Response continue_resumable_download(
+	std::string_view const url, 
+	std::string_view const file_path, 
+	ResumableDownloadOptions const& options
+) {
+	auto const state_file_path = get_download_state_file_path(file_path);
+
+	auto headers = options.headers;
+
+	auto bytes_downloaded = std::uint64_t{};
+	if (auto state_file = std::ifstream{utils::utf8_to_path(state_file_path)}) {
+		auto state = std::string{};
+		std::getline(state_file, state);
+		
+		auto error_code = std::error_code{};
+		bytes_downloaded = std::filesystem::file_size(utils::utf8_to_path(file_path), error_code);
+		
+		if (auto const if_range = parse_download_state(state); if_range && !error_code && bytes_downloaded > 0) {
+			headers.push_back(HeaderCopy{.name = "Range", .value = byte_range_to_range_header_value({.first = bytes_downloaded, .last{}})});
+			headers.push_back(static_cast<HeaderCopy>(*if_range));
+		}
+		else bytes_downloaded = 0;
+	}
+
+	auto file = std::optional<utils::OutputFile>{};
+	auto action = ResumableDownloadAction::Fail;
+
+	auto response = make_request(RequestMethod::Get, url, options.default_protocol)
+		.add_headers(std::span<HeaderCopy const>{headers})
+		.set_headers_callback([&](ResponseProgressHeaders& progress) {
+			action = get_resumable_download_action(progress.get_status_code(), progress.get_content_range(), bytes_downloaded);
+
+			switch (action) {
+				case ResumableDownloadAction::Append:
+					file.emplace(file_path, utils::OutputFile::Mode::Append);
+					return;
+				case ResumableDownloadAction::Restart:
+					file.emplace(file_path, utils::OutputFile::Mode::Truncate);
+					if (auto const validator = get_if_range_validator(progress)) {
+						auto state_file = std::ofstream{utils::utf8_to_path(state_file_path)};
+						state_file << download_state_to_string(*validator);
+					}
+					else std::filesystem::remove(utils::utf8_to_path(state_file_path));
+
+					if (auto const content_length = progress.get_header_value(KnownHeader::ContentLength)) {
+						if (auto const size = utils::string_to_integral<std::uint64_t>(*content_length)) {
+							file->preallocate(*size);
+						}
+					}
+					return;
+				default:
+					// Leave the partial file as it is.
+					progress.stop();
+			}
+		})
+		.set_body_sink([&](std::span<std::byte const> const data) {
+			file->write(data);
+		})
+		.send();
+
+	if (action == ResumableDownloadAction::RangeMismatch) {
+		throw errors::ResponseParsingFailed{"The server sent a different byte range than the one that was requested."};
+	}
+	if (file || action == ResumableDownloadAction::Complete) {
+		std::filesystem::remove(utils::utf8_to_path(state_file_path));
+	}
+
+	return response;
+}
+
+} // namespace algorithms
+
+/*
+	Downloads a resource into a file in a way that can be resumed if it is interrupted.
+	
+	While the download is in progress, a state file is kept next to the partial file 
+	(see algorithms::get_download_state_file_path). If a download of the same file was 
+	interrupted earlier, only the missing bytes are requested, with an If-Range header 
+	so that the server sends the whole resource instead if it has changed since then.
+	The state file is removed when the download has completed.
+
+	Failed attempts are retried options.max_attempts times in total, after which the 
+	last errors::ConnectionFailed is rethrown. Calling the function again later resumes 
+	the download.
+
+	The returned Response is the response to the last request, without any body. 
+	If its status code is 200 (OK), 206 (Partial Content) or 416 (Range Not Satisfiable), 
+	the file contains the whole resource (see algorithms::get_resumable_download_action).
+	Otherwise the file is left as it was. If the server responds with a byte range 
+	that was not requested, the file is also left as it was and errors::ResponseParsingFailed is thrown.
+*/
+inline Response download_file_resumable(
+	std::string_view const url, 
+	std::string_view const file_path, 
+	ResumableDownloadOptions const& options = {}
+) {
+	for (auto attempt = std::size_t{1};; ++attempt) {
+		try {
+			return algorithms::continue_resumable_download(url, file_path, options);
+		}
+		catch (errors::ConnectionFailed const&) {
+			if (attempt >= options.max_attempts) {
+				throw;
+			}
+		}
+	}
 }
 
 } // namespace http_client
@@ -29,6 +29,8 @@ SOFTWARE.
 #include <cassert>
 #include <chrono>
 #include <cstring>
+#include <limits>
+#include <stdexcept>
 #include <system_error>
 
 using namespace std::chrono_literals;
@@ -66,6 +68,7 @@ using namespace std::chrono_literals;
 #	include <fcntl.h>
 #	include <netdb.h>
 #	include <netinet/tcp.h>
+#	include <poll.h>
 #	include <sys/socket.h>
 #	include <unistd.h>
 
@@ -78,6 +81,17 @@ using namespace std::chrono_literals;
 #	endif
 #endif // __has_include(<unistd.h>)
 
+#ifdef CPP20_HTTP_CLIENT_HAS_ZLIB
+#	define ZLIB_CONST
+#	include <zlib.h>
+#endif
+#ifdef CPP20_HTTP_CLIENT_HAS_BROTLI
+#	include <brotli/decode.h>
+#endif
+#ifdef CPP20_HTTP_CLIENT_HAS_ZSTD
+#	include <zstd.h>
+#endif
+
 //---------------------------------------------------------
 
 namespace http_client {
@@ -232,6 +246,14 @@ void throw_connection_error(std::string reason, int const error_code = errno, bo
 
 #endif // IS_POSIX
 
+/*
+	Converts a timeout to the int milliseconds that poll functions take.
+*/
+[[nodiscard]]
+int timeout_to_poll_milliseconds(std::chrono::milliseconds const timeout) noexcept {
+	return static_cast<int>(std::clamp<std::chrono::milliseconds::rep>(timeout.count(), 0, std::numeric_limits<int>::max()));
+}
+
 } // namespace utils
 
 #ifdef _WIN32
@@ -344,6 +366,20 @@ public:
 	{
 		return read(buffer, true);
 	}
+	[[nodiscard]]
+	bool wait_for_data(std::chrono::milliseconds const timeout) {
+		if (is_closed_) {
+			return true;
+		}
+		
+		auto poll_descriptor = WSAPOLLFD{.fd = handle_.get(), .events = POLLRDNORM};
+		if (auto const result = WSAPoll(&poll_descriptor, 1, utils::timeout_to_poll_milliseconds(timeout)); 
+			result != SOCKET_ERROR) 
+		{
+			return result > 0;
+		}
+		utils::throw_connection_error("Failed to wait for data from socket", WSAGetLastError());
+	}
 
 	RawSocket(std::string_view const server, Port const port) :
 		address_info_{get_address_info_(server, port)},
@@ -841,6 +877,10 @@ public:
 	{
 		return read(buffer, true);
 	}
+	[[nodiscard]]
+	bool wait_for_data(std::chrono::milliseconds const timeout) {
+		return !decrypted_message_left_.empty() || raw_socket_->wait_for_data(timeout);
+	}
 
 	TlsSocket(std::string_view const server, Port const port) 
 	{
@@ -1069,6 +1109,18 @@ public:
 	{
 		return read(buffer, true);
 	}
+	[[nodiscard]]
+	bool wait_for_data(std::chrono::milliseconds const timeout) {
+		if (is_closed_) {
+			return true;
+		}
+
+		auto poll_descriptor = pollfd{.fd = handle_.get(), .events = POLLIN, .revents = 0};
+		if (auto const result = ::poll(&poll_descriptor, 1, utils::timeout_to_poll_milliseconds(timeout)); result != -1) {
+			return result > 0;
+		}
+		utils::throw_connection_error("Failed to wait for data from socket");
+	}
 
 	RawSocket(std::string_view const server, Port const port) :
 		address_info_{get_address_info_(std::string{server}, port)}, 
@@ -1216,6 +1268,11 @@ public:
 		}
 		utils::unreachable();
 	}
+	[[nodiscard]]
+	bool wait_for_data(std::chrono::milliseconds const timeout) {
+		// Data that OpenSSL has already received and decrypted is not visible to poll.
+		return is_closed_ || ::SSL_pending(tls_connection_.get()) > 0 || raw_socket_->wait_for_data(timeout);
+	}
 
 	TlsSocket(std::string_view const server, Port const port) {
 		initialize_connection_(server, port);
@@ -1329,6 +1386,9 @@ public:
 	auto read(std::span<std::byte> const buffer)
 		-> std::variant<ConnectionClosed, std::size_t> 
 	{
+		if (auto const peeked_data_result = read_peeked_data_(buffer)) {
+			return *peeked_data_result;
+		}
 		if (std::holds_alternative<RawSocket>(socket_)) {
 			return std::get<RawSocket>(socket_).read(buffer);
 		}
@@ -1338,10 +1398,49 @@ public:
 	auto read_available(std::span<std::byte> const buffer) 
 		-> std::variant<ConnectionClosed, std::size_t> 
 	{
+		if (auto const peeked_data_result = read_peeked_data_(buffer)) {
+			return *peeked_data_result;
+		}
+		return read_available_from_socket_(buffer);
+	}
+	[[nodiscard]]
+	auto peek_available(std::span<std::byte> const buffer) 
+		-> std::variant<ConnectionClosed, std::size_t> 
+	{
+		if (!is_closed_after_peeked_data_ && peeked_data_.size() < buffer.size()) {
+			auto const peeked_size = peeked_data_.size();
+			peeked_data_.resize(buffer.size());
+			
+			auto const read_result = read_available_from_socket_(std::span{peeked_data_}.subspan(peeked_size));
+			if (std::holds_alternative<std::size_t>(read_result)) {
+				peeked_data_.resize(peeked_size + std::get<std::size_t>(read_result));
+			}
+			else {
+				peeked_data_.resize(peeked_size);
+				is_closed_after_peeked_data_ = true;
+			}
+		}
+		if (peeked_data_.empty() && is_closed_after_peeked_data_) {
+			return ConnectionClosed{};
+		}
+		
+		auto const size = std::min(peeked_data_.size(), buffer.size());
+		std::ranges::copy(std::span{peeked_data_}.first(size), buffer.begin());
+		return size;
+	}
+	[[nodiscard]]
+	bool get_is_closed_after_peeked_data() const noexcept {
+		return is_closed_after_peeked_data_;
+	}
+	[[nodiscard]]
+	bool wait_for_data(std::chrono::milliseconds const timeout) {
+		if (is_closed_after_peeked_data_) {
+			return true;
+		}
 		if (std::holds_alternative<RawSocket>(socket_)) {
-			return std::get<RawSocket>(socket_).read_available(buffer);
+			return std::get<RawSocket>(socket_).wait_for_data(timeout);
 		}
-		return std::get<TlsSocket>(socket_).read_available(buffer);
+		return std::get<TlsSocket>(socket_).wait_for_data(timeout);
 	}
 
 	Implementation(std::string_view const server, Port const port, bool const is_tls_encrypted) :
@@ -1360,7 +1459,41 @@ private:
 		return RawSocket{server, port};
 	}
 
+	[[nodiscard]]
+	auto read_available_from_socket_(std::span<std::byte> const buffer) 
+		-> std::variant<ConnectionClosed, std::size_t> 
+	{
+		if (std::holds_alternative<RawSocket>(socket_)) {
+			return std::get<RawSocket>(socket_).read_available(buffer);
+		}
+		return std::get<TlsSocket>(socket_).read_available(buffer);
+	}
+	/*
+		Reads data that was peeked before reading from the socket itself.
+		Returns nothing if there is no such data.
+	*/
+	[[nodiscard]]
+	auto read_peeked_data_(std::span<std::byte> const buffer) 
+		-> std::optional<std::variant<ConnectionClosed, std::size_t>> 
+	{
+		if (!peeked_data_.empty()) {
+			auto const size = std::min(peeked_data_.size(), buffer.size());
+			std::ranges::copy(std::span{peeked_data_}.first(size), buffer.begin());
+			peeked_data_.erase(peeked_data_.begin(), peeked_data_.begin() + static_cast<std::ptrdiff_t>(size));
+			return size;
+		}
+		if (is_closed_after_peeked_data_) {
+			return ConnectionClosed{};
+		}
+		return {};
+	}
+
 	SocketVariant socket_;
+
+	// Data that has been received by peek_available, but not read yet.
+	std::vector<std::byte> peeked_data_;
+	// Whether the peer closed the connection after sending peeked_data_.
+	bool is_closed_after_peeked_data_{false};
 };
 
 void Socket::write(std::span<std::byte const> data) const {
@@ -1379,6 +1512,20 @@ auto Socket::read_available(std::span<std::byte> buffer) const
 	return implementation_->read_available(buffer);
 }
 
+auto Socket::peek_available(std::span<std::byte> buffer) const 
+	-> std::variant<ConnectionClosed, std::size_t> 
+{
+	return implementation_->peek_available(buffer);
+}
+
+bool Socket::get_is_closed_after_peeked_data() const noexcept {
+	return implementation_->get_is_closed_after_peeked_data();
+}
+
+bool Socket::wait_for_data(std::chrono::milliseconds const timeout) const {
+	return implementation_->wait_for_data(timeout);
+}
+
 Socket::Socket(std::string_view const server, Port const port, bool const is_tls_encrypted) :
 	implementation_{std::make_unique<Implementation>(server, port, is_tls_encrypted)}
 {}
@@ -1387,4 +1534,642 @@ Socket::~Socket() = default;
 Socket::Socket(Socket&&) noexcept = default;
 Socket& Socket::operator=(Socket&&) noexcept = default;
 
+//---------------------------------------------------------
+
+#ifdef _WIN32
+
+class utils::OutputFile::Implementation {
+public:
+	void write(std::span<std::byte const> data) {
+		while (!data.empty()) {
+			auto const size_to_write = static_cast<DWORD>(std::min(data.size(), std::size_t{std::numeric_limits<DWORD>::max()}));
+			auto bytes_written = DWORD{};
+			if (!::WriteFile(handle_.get(), data.data(), size_to_write, &bytes_written, nullptr)) {
+				throw_error_("Failed to write to file");
+			}
+			data = data.subspan(bytes_written);
+		}
+	}
+
+	void write_at(std::span<std::byte const> data, std::uint64_t offset) {
+		while (!data.empty()) {
+			auto const size_to_write = static_cast<DWORD>(std::min(data.size(), std::size_t{std::numeric_limits<DWORD>::max()}));
+			auto overlapped = OVERLAPPED{};
+			overlapped.Offset = static_cast<DWORD>(offset);
+			overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+			auto bytes_written = DWORD{};
+			if (!::WriteFile(handle_.get(), data.data(), size_to_write, &bytes_written, &overlapped)) {
+				throw_error_("Failed to write to file");
+			}
+			data = data.subspan(bytes_written);
+			offset += bytes_written;
+		}
+	}
+
+	void preallocate(std::uint64_t const size) {
+		// Allocation size does not affect the end of file position.
+		auto allocation_info = FILE_ALLOCATION_INFO{};
+		allocation_info.AllocationSize.QuadPart = static_cast<LONGLONG>(size);
+		if (!::SetFileInformationByHandle(handle_.get(), FileAllocationInfo, &allocation_info, sizeof(allocation_info))) {
+			throw_error_("Failed to preallocate file");
+		}
+	}
+
+	Implementation(std::string_view const path, OutputFile::Mode const mode) :
+		handle_{open_file_(path, mode)}
+	{
+		if (mode == OutputFile::Mode::Append && !::SetFilePointerEx(handle_.get(), LARGE_INTEGER{}, nullptr, FILE_END)) {
+			throw_error_("Failed to seek to the end of file");
+		}
+	}
+
+private:
+	// INVALID_HANDLE_VALUE is not a constant expression, so utils::UniqueHandle can't be used.
+	using FileHandle = std::unique_ptr<void, decltype([](HANDLE const h){ ::CloseHandle(h); })>;
+
+	[[noreturn]]
+	static void throw_error_(char const* const reason) {
+		throw std::system_error{static_cast<int>(GetLastError()), std::system_category(), reason};
+	}
+
+	[[nodiscard]]
+	static HANDLE open_file_(std::string_view const path, OutputFile::Mode const mode) {
+		auto const handle = ::CreateFileW(
+			utils::win::utf8_to_wide(path).data(),
+			GENERIC_WRITE,
+			0,
+			nullptr,
+			mode == OutputFile::Mode::Append ? OPEN_ALWAYS : CREATE_ALWAYS,
+			FILE_ATTRIBUTE_NORMAL,
+			nullptr
+		);
+		if (handle == INVALID_HANDLE_VALUE) {
+			throw_error_("Failed to open file for writing");
+		}
+		return handle;
+	}
+
+	FileHandle handle_;
+};
+
+#endif // _WIN32
+
+#ifdef IS_POSIX
+
+class utils::OutputFile::Implementation {
+public:
+	void write(std::span<std::byte const> data) {
+		while (!data.empty()) {
+			if (auto const result = ::write(handle_.get(), data.data(), data.size()); result >= 0) {
+				data = data.subspan(static_cast<std::size_t>(result));
+			}
+			else if (errno != EINTR) {
+				throw_error_("Failed to write to file");
+			}
+		}
+	}
+
+	void write_at(std::span<std::byte const> data, std::uint64_t offset) {
+		while (!data.empty()) {
+			if (auto const result = ::pwrite(handle_.get(), data.data(), data.size(), static_cast<off_t>(offset)); result >= 0) {
+				data = data.subspan(static_cast<std::size_t>(result));
+				offset += static_cast<std::uint64_t>(result);
+			}
+			else if (errno != EINTR) {
+				throw_error_("Failed to write to file");
+			}
+		}
+	}
+
+	void preallocate([[maybe_unused]] std::uint64_t const size) {
+		// Only reserve the blocks, the size of the file should still reflect what has been written.
+#if defined(__linux__)
+		if (::fallocate(handle_.get(), FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(size)) == -1 && 
+			errno != EOPNOTSUPP && errno != ENOSYS) 
+		{
+			throw_error_("Failed to preallocate file");
+		}
+#elif defined(__APPLE__)
+		auto store = fstore_t{
+			.fst_flags = F_ALLOCATEALL,
+			.fst_posmode = F_PEOFPOSMODE,
+			.fst_offset = 0,
+			.fst_length = static_cast<off_t>(size),
+			.fst_bytesalloc = 0,
+		};
+		// Failing to preallocate is not an error, the file just grows as it is written to.
+		::fcntl(handle_.get(), F_PREALLOCATE, &store);
+#endif
+	}
+
+	Implementation(std::string_view const path, OutputFile::Mode const mode) :
+		handle_{::open(
+			std::string{path}.c_str(), 
+			O_WRONLY | O_CREAT | O_CLOEXEC | (mode == OutputFile::Mode::Truncate ? O_TRUNC : 0), 
+			0666
+		)}
+	{
+		if (!handle_) {
+			throw_error_("Failed to open file for writing");
+		}
+		// O_APPEND is not used because it makes pwrite append on Linux.
+		if (mode == OutputFile::Mode::Append && ::lseek(handle_.get(), 0, SEEK_END) == -1) {
+			throw_error_("Failed to seek to the end of file");
+		}
+	}
+
+private:
+	[[noreturn]]
+	static void throw_error_(char const* const reason) {
+		throw std::system_error{errno, std::generic_category(), reason};
+	}
+
+	using FileHandle = utils::UniqueHandle<int, decltype([](auto const handle){ ::close(handle); }), -1>;
+
+	FileHandle handle_;
+};
+
+#endif // IS_POSIX
+
+void utils::OutputFile::write(std::span<std::byte const> const data) {
+	implementation_->write(data);
+}
+
+void utils::OutputFile::write_at(std::span<std::byte const> const data, std::uint64_t const offset) {
+	implementation_->write_at(data, offset);
+}
+
+void utils::OutputFile::preallocate(std::uint64_t const size) {
+	implementation_->preallocate(size);
+}
+
+utils::OutputFile::OutputFile(std::string_view const path, Mode const mode) :
+	implementation_{std::make_unique<Implementation>(path, mode)}
+{}
+utils::OutputFile::~OutputFile() = default;
+
+utils::OutputFile::OutputFile(OutputFile&&) noexcept = default;
+utils::OutputFile& utils::OutputFile::operator=(OutputFile&&) noexcept = default;
+
+//---------------------------------------------------------
+
+bool get_is_content_encoding_supported(ContentEncoding const encoding) noexcept {
+	using enum ContentEncoding;
+	switch (encoding) {
+		case Identity: 
+			return true;
+		case Gzip:
+		case Deflate:
+#ifdef CPP20_HTTP_CLIENT_HAS_ZLIB
+			return true;
+#else
+			return false;
+#endif
+		case Brotli:
+#ifdef CPP20_HTTP_CLIENT_HAS_BROTLI
+			return true;
+#else
+			return false;
+#endif
+		case Zstd:
+#ifdef CPP20_HTTP_CLIENT_HAS_ZSTD
+			return true;
+#else
+			return false;
+#endif
+	}
+	return false;
+}
+
+bool get_is_content_compression_supported(ContentEncoding const encoding) noexcept {
+	return encoding != ContentEncoding::Identity && encoding != ContentEncoding::Brotli && get_is_content_encoding_supported(encoding);
+}
+
+class algorithms::ContentDecoder::Implementation {
+public:
+	void decode(std::span<std::byte const> const data, BodySink const& output) {
+		using enum ContentEncoding;
+		switch (encoding_) {
+			case Identity:
+				output(data);
+				return;
+#ifdef CPP20_HTTP_CLIENT_HAS_ZLIB
+			case Gzip:
+			case Deflate:
+				decode_zlib_(data, output);
+				return;
+#endif
+#ifdef CPP20_HTTP_CLIENT_HAS_BROTLI
+			case Brotli:
+				decode_brotli_(data, output);
+				return;
+#endif
+#ifdef CPP20_HTTP_CLIENT_HAS_ZSTD
+			case Zstd:
+				decode_zstd_(data, output);
+				return;
+#endif
+			default:
+				// The constructor does not allow unsupported encodings.
+				utils::unreachable();
+		}
+	}
+
+	[[nodiscard]]
+	bool get_is_finished() const noexcept {
+		return is_finished_;
+	}
+
+	Implementation(ContentEncoding const encoding) :
+		encoding_{encoding}
+	{
+		if (!get_is_content_encoding_supported(encoding)) {
+			throw errors::ResponseParsingFailed{std::format(
+				"The \"{}\" content encoding is not supported by this build of the library.", 
+				content_encoding_to_string(encoding)
+			)};
+		}
+#ifdef CPP20_HTTP_CLIENT_HAS_ZLIB
+		if (encoding == ContentEncoding::Gzip) {
+			// 16 is added to the window bits to only accept gzip headers.
+			initialize_zlib_(MAX_WBITS + 16);
+		}
+#endif
+#ifdef CPP20_HTTP_CLIENT_HAS_BROTLI
+		if (encoding == ContentEncoding::Brotli) {
+			brotli_state_.reset(BrotliDecoderCreateInstance(nullptr, nullptr, nullptr));
+			if (!brotli_state_) {
+				throw std::bad_alloc{};
+			}
+		}
+#endif
+#ifdef CPP20_HTTP_CLIENT_HAS_ZSTD
+		if (encoding == ContentEncoding::Zstd) {
+			zstd_stream_.reset(ZSTD_createDStream());
+			if (!zstd_stream_) {
+				throw std::bad_alloc{};
+			}
+		}
+#endif
+	}
+	~Implementation() {
+#ifdef CPP20_HTTP_CLIENT_HAS_ZLIB
+		if (is_zlib_initialized_) {
+			inflateEnd(&zlib_stream_);
+		}
+#endif
+	}
+
+	Implementation(Implementation const&) = delete;
+	Implementation& operator=(Implementation const&) = delete;
+	Implementation(Implementation&&) = delete;
+	Implementation& operator=(Implementation&&) = delete;
+
+private:
+	void write_output_(std::size_t const size, BodySink const& output) {
+		if (size > 0) {
+			output(std::span{output_buffer_}.first(size));
+		}
+	}
+
+	[[noreturn]]
+	void throw_decoding_error_(std::string_view const reason) const {
+		throw errors::ResponseParsingFailed{std::format(
+			"Failed decoding the {} encoded response body: {}", 
+			content_encoding_to_string(encoding_), reason
+		)};
+	}
+
+#ifdef CPP20_HTTP_CLIENT_HAS_ZLIB
+	void initialize_zlib_(int const window_bits) {
+		if (inflateInit2(&zlib_stream_, window_bits) != Z_OK) {
+			throw std::bad_alloc{};
+		}
+		is_zlib_initialized_ = true;
+	}
+
+	void decode_zlib_(std::span<std::byte const> data, BodySink const& output) {
+		if (!is_zlib_initialized_) {
+			// The deflate content encoding is supposed to be deflate data with a zlib wrapper, 
+			// but some servers send raw deflate data. The two are told apart by the zlib header.
+			auto const header_part_size = std::min(deflate_header_.size() - deflate_header_size_, data.size());
+			std::ranges::copy(data.first(header_part_size), deflate_header_.begin() + static_cast<std::ptrdiff_t>(deflate_header_size_));
+			deflate_header_size_ += header_part_size;
+			data = data.subspan(header_part_size);
+
+			if (deflate_header_size_ < deflate_header_.size()) {
+				return;
+			}
+
+			auto const compression_method_and_flags = static_cast<unsigned>(deflate_header_[0]);
+			auto const flags = static_cast<unsigned>(deflate_header_[1]);
+			auto const is_zlib_wrapped = (compression_method_and_flags & 0x0fu) == static_cast<unsigned>(Z_DEFLATED)
+				&& (compression_method_and_flags*256 + flags) % 31 == 0;
+
+			// Negative window bits means raw deflate data.
+			initialize_zlib_(is_zlib_wrapped ? MAX_WBITS : -MAX_WBITS);
+			inflate_(deflate_header_, output);
+		}
+		inflate_(data, output);
+	}
+
+	void inflate_(std::span<std::byte const> data, BodySink const& output) {
+		while (!data.empty()) {
+			if (is_finished_) {
+				if (encoding_ != ContentEncoding::Gzip) {
+					throw_decoding_error_("there is data after the end of the compressed data.");
+				}
+				// A gzip body can consist of multiple members that are decompressed one after another.
+				inflateReset(&zlib_stream_);
+				is_finished_ = false;
+			}
+
+			auto const input = data.first(std::min<std::size_t>(data.size(), std::numeric_limits<uInt>::max()));
+			zlib_stream_.next_in = reinterpret_cast<Bytef const*>(input.data());
+			zlib_stream_.avail_in = static_cast<uInt>(input.size());
+
+			do {
+				zlib_stream_.next_out = reinterpret_cast<Bytef*>(output_buffer_.data());
+				zlib_stream_.avail_out = static_cast<uInt>(output_buffer_.size());
+				
+				auto const result = inflate(&zlib_stream_, Z_NO_FLUSH);
+				if (result == Z_STREAM_END) {
+					is_finished_ = true;
+				}
+				// Z_BUF_ERROR only means that no progress could be made with the data so far.
+				else if (result != Z_OK && result != Z_BUF_ERROR) {
+					throw_decoding_error_(zlib_stream_.msg ? zlib_stream_.msg : "invalid data.");
+				}
+				write_output_(output_buffer_.size() - zlib_stream_.avail_out, output);
+			} while (zlib_stream_.avail_out == 0 && !is_finished_);
+
+			data = data.subspan(input.size() - zlib_stream_.avail_in);
+		}
+	}
+
+	z_stream zlib_stream_{};
+	bool is_zlib_initialized_{false};
+
+	std::array<std::byte, 2> deflate_header_{};
+	std::size_t deflate_header_size_{};
+#endif // CPP20_HTTP_CLIENT_HAS_ZLIB
+
+#ifdef CPP20_HTTP_CLIENT_HAS_BROTLI
+	void decode_brotli_(std::span<std::byte const> const data, BodySink const& output) {
+		auto next_input = reinterpret_cast<std::uint8_t const*>(data.data());
+		auto available_input = data.size();
+
+		while (true) {
+			if (is_finished_) {
+				if (available_input > 0) {
+					throw_decoding_error_("there is data after the end of the compressed data.");
+				}
+				return;
+			}
+
+			auto next_output = reinterpret_cast<std::uint8_t*>(output_buffer_.data());
+			auto available_output = output_buffer_.size();
+
+			auto const result = BrotliDecoderDecompressStream(
+				brotli_state_.get(), &available_input, &next_input, &available_output, &next_output, nullptr
+			);
+			write_output_(output_buffer_.size() - available_output, output);
+
+			switch (result) {
+				case BROTLI_DECODER_RESULT_SUCCESS:
+					is_finished_ = true;
+					break;
+				case BROTLI_DECODER_RESULT_NEEDS_MORE_INPUT:
+					return;
+				case BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT:
+					break;
+				case BROTLI_DECODER_RESULT_ERROR:
+					throw_decoding_error_(BrotliDecoderErrorString(BrotliDecoderGetErrorCode(brotli_state_.get())));
+			}
+		}
+	}
+
+	std::unique_ptr<BrotliDecoderState, decltype([](BrotliDecoderState* const state){ BrotliDecoderDestroyInstance(state); })> brotli_state_;
+#endif // CPP20_HTTP_CLIENT_HAS_BROTLI
+
+#ifdef CPP20_HTTP_CLIENT_HAS_ZSTD
+	void decode_zstd_(std::span<std::byte const> const data, BodySink const& output) {
+		auto input = ZSTD_inBuffer{data.data(), data.size(), 0};
+		
+		auto is_output_full = false;
+		do {
+			auto zstd_output = ZSTD_outBuffer{output_buffer_.data(), output_buffer_.size(), 0};
+
+			// A body can consist of multiple frames, which are decompressed one after another.
+			auto const result = ZSTD_decompressStream(zstd_stream_.get(), &zstd_output, &input);
+			if (ZSTD_isError(result)) {
+				throw_decoding_error_(ZSTD_getErrorName(result));
+			}
+			write_output_(zstd_output.pos, output);
+
+			// 0 means that a frame has been completely decoded and flushed.
+			is_finished_ = result == 0;
+			is_output_full = zstd_output.pos == zstd_output.size;
+		} while (input.pos < input.size || (is_output_full && !is_finished_));
+	}
+
+	std::unique_ptr<ZSTD_DStream, decltype([](ZSTD_DStream* const stream){ ZSTD_freeDStream(stream); })> zstd_stream_;
+#endif // CPP20_HTTP_CLIENT_HAS_ZSTD
+
+	ContentEncoding encoding_;
+	bool is_finished_{false};
+
+	std::array<std::byte, std::size_t{1} << 14> output_buffer_;
+};
+
+void algorithms::ContentDecoder::decode(std::span<std::byte const> const data, BodySink const& output) {
+	implementation_->decode(data, output);
+}
+
+bool algorithms::ContentDecoder::get_is_finished() const noexcept {
+	return implementation_->get_is_finished();
+}
+
+algorithms::ContentDecoder::ContentDecoder(ContentEncoding const encoding) :
+	implementation_{std::make_unique<Implementation>(encoding)}
+{}
+algorithms::ContentDecoder::~ContentDecoder() = default;
+
+algorithms::ContentDecoder::ContentDecoder(ContentDecoder&&) noexcept = default;
+algorithms::ContentDecoder& algorithms::ContentDecoder::operator=(ContentDecoder&&) noexcept = default;
+
+class algorithms::ContentEncoder::Implementation {
+public:
+	void encode(std::span<std::byte const> const data, BodySink const& output) {
+		if (is_finished_) {
+			throw std::logic_error{"ContentEncoder::encode was called after ContentEncoder::finish."};
+		}
+		compress_(data, false, output);
+	}
+	void finish(BodySink const& output) {
+		if (!is_finished_) {
+			compress_({}, true, output);
+			is_finished_ = true;
+		}
+	}
+
+	Implementation(ContentEncoding const encoding, std::optional<int> const level) :
+		encoding_{encoding}
+	{
+		if (encoding == ContentEncoding::Identity) {
+			throw std::invalid_argument{"The identity content encoding is not a compression, and must not be sent in a Content-Encoding header."};
+		}
+		if (!get_is_content_compression_supported(encoding)) {
+			throw std::invalid_argument{std::format(
+				"Compressing with the \"{}\" content encoding is not supported by this build of the library.", 
+				content_encoding_to_string(encoding)
+			)};
+		}
+#ifdef CPP20_HTTP_CLIENT_HAS_ZLIB
+		if (encoding == ContentEncoding::Gzip || encoding == ContentEncoding::Deflate) {
+			if (level && (*level < 0 || *level > 9)) {
+				throw_invalid_level_(*level);
+			}
+			// 16 is added to the window bits to write a gzip header instead of a zlib header.
+			auto const window_bits = encoding == ContentEncoding::Gzip ? MAX_WBITS + 16 : MAX_WBITS;
+			if (deflateInit2(&zlib_stream_, level.value_or(Z_DEFAULT_COMPRESSION), Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+				throw std::bad_alloc{};
+			}
+			is_zlib_initialized_ = true;
+		}
+#endif
+#ifdef CPP20_HTTP_CLIENT_HAS_ZSTD
+		if (encoding == ContentEncoding::Zstd) {
+			// Zstd also has negative levels and level 0, which means the default level.
+			// Only the levels of the documented range are accepted.
+			if (level && (*level < 1 || *level > ZSTD_maxCLevel())) {
+				throw_invalid_level_(*level);
+			}
+			zstd_context_.reset(ZSTD_createCCtx());
+			if (!zstd_context_) {
+				throw std::bad_alloc{};
+			}
+			if (level) {
+				ZSTD_CCtx_setParameter(zstd_context_.get(), ZSTD_c_compressionLevel, *level);
+			}
+		}
+#endif
+	}
+	~Implementation() {
+#ifdef CPP20_HTTP_CLIENT_HAS_ZLIB
+		if (is_zlib_initialized_) {
+			deflateEnd(&zlib_stream_);
+		}
+#endif
+	}
+
+	Implementation(Implementation const&) = delete;
+	Implementation& operator=(Implementation const&) = delete;
+	Implementation(Implementation&&) = delete;
+	Implementation& operator=(Implementation&&) = delete;
+
+private:
+	[[noreturn]]
+	void throw_invalid_level_(int const level) const {
+		throw std::invalid_argument{std::format(
+			"{} is not a valid compression level for the \"{}\" content encoding.", 
+			level, content_encoding_to_string(encoding_)
+		)};
+	}
+
+	void write_output_(std::size_t const size, BodySink const& output) {
+		if (size > 0) {
+			output(std::span{output_buffer_}.first(size));
+		}
+	}
+
+	void compress_(std::span<std::byte const> const data, bool const is_last, BodySink const& output) {
+		using enum ContentEncoding;
+		switch (encoding_) {
+#ifdef CPP20_HTTP_CLIENT_HAS_ZLIB
+			case Gzip:
+			case Deflate:
+				compress_zlib_(data, is_last, output);
+				return;
+#endif
+#ifdef CPP20_HTTP_CLIENT_HAS_ZSTD
+			case Zstd:
+				compress_zstd_(data, is_last, output);
+				return;
+#endif
+			default:
+				// The constructor does not allow unsupported encodings.
+				utils::unreachable();
+		}
+	}
+
+#ifdef CPP20_HTTP_CLIENT_HAS_ZLIB
+	void compress_zlib_(std::span<std::byte const> data, bool const is_last, BodySink const& output) {
+		do {
+			auto const input = data.first(std::min<std::size_t>(data.size(), std::numeric_limits<uInt>::max()));
+			data = data.subspan(input.size());
+			
+			zlib_stream_.next_in = reinterpret_cast<Bytef const*>(input.data());
+			zlib_stream_.avail_in = static_cast<uInt>(input.size());
+
+			auto const flush = is_last && data.empty() ? Z_FINISH : Z_NO_FLUSH;
+			auto result = Z_OK;
+			do {
+				zlib_stream_.next_out = reinterpret_cast<Bytef*>(output_buffer_.data());
+				zlib_stream_.avail_out = static_cast<uInt>(output_buffer_.size());
+				
+				result = deflate(&zlib_stream_, flush);
+				write_output_(output_buffer_.size() - zlib_stream_.avail_out, output);
+				// With Z_FINISH, deflate returns Z_STREAM_END once all output has been written.
+			} while (flush == Z_FINISH ? result != Z_STREAM_END : zlib_stream_.avail_out == 0);
+		} while (!data.empty());
+	}
+
+	z_stream zlib_stream_{};
+	bool is_zlib_initialized_{false};
+#endif // CPP20_HTTP_CLIENT_HAS_ZLIB
+
+#ifdef CPP20_HTTP_CLIENT_HAS_ZSTD
+	void compress_zstd_(std::span<std::byte const> const data, bool const is_last, BodySink const& output) {
+		auto input = ZSTD_inBuffer{data.data(), data.size(), 0};
+		auto const mode = is_last ? ZSTD_e_end : ZSTD_e_continue;
+		
+		auto remaining = std::size_t{};
+		do {
+			auto zstd_output = ZSTD_outBuffer{output_buffer_.data(), output_buffer_.size(), 0};
+			remaining = ZSTD_compressStream2(zstd_context_.get(), &zstd_output, &input, mode);
+			if (ZSTD_isError(remaining)) {
+				throw std::runtime_error{std::format("Zstd compression failed: {}", ZSTD_getErrorName(remaining))};
+			}
+			write_output_(zstd_output.pos, output);
+			// With ZSTD_e_end, the return value is the amount of data that is left to be flushed.
+		} while (is_last ? remaining != 0 : input.pos < input.size);
+	}
+
+	std::unique_ptr<ZSTD_CCtx, decltype([](ZSTD_CCtx* const context){ ZSTD_freeCCtx(context); })> zstd_context_;
+#endif // CPP20_HTTP_CLIENT_HAS_ZSTD
+
+	ContentEncoding encoding_;
+	bool is_finished_{false};
+
+	std::array<std::byte, std::size_t{1} << 14> output_buffer_;
+};
+
+void algorithms::ContentEncoder::encode(std::span<std::byte const> const data, BodySink const& output) {
+	implementation_->encode(data, output);
+}
+
+void algorithms::ContentEncoder::finish(BodySink const& output) {
+	implementation_->finish(output);
+}
+
+algorithms::ContentEncoder::ContentEncoder(ContentEncoding const encoding, std::optional<int> const level) :
+	implementation_{std::make_unique<Implementation>(encoding, level)}
+{}
+algorithms::ContentEncoder::~ContentEncoder() = default;
+
+algorithms::ContentEncoder::ContentEncoder(ContentEncoder&&) noexcept = default;
+algorithms::ContentEncoder& algorithms::ContentEncoder::operator=(ContentEncoder&&) noexcept = default;
+
 } // namespace http_client
@@ -0,0 +1,52 @@
+#include "testing_header.hpp"
+
+#include <bit>
+
+TEST_CASE("equal_ascii_case_insensitive") {
+	STATIC_REQUIRE(utils::equal_ascii_case_insensitive("Content-Type", "content-TYPE"));
+	STATIC_REQUIRE(!utils::equal_ascii_case_insensitive("Content-Type", "Content-Typ"));
+	STATIC_REQUIRE(utils::ascii_to_lowercase('@') == '@');
+	STATIC_REQUIRE(utils::ascii_to_lowercase('[') == '[');
+
+	CHECK(utils::equal_ascii_case_insensitive("", ""));
+	CHECK(utils::equal_ascii_case_insensitive("ACCESS-CONTROL-ALLOW-ORIGIN", "access-control-allow-origin"));
+	CHECK(!utils::equal_ascii_case_insensitive("access-control-allow-origin", "access-control-allow-origiN_"));
+	CHECK(!utils::equal_ascii_case_insensitive("access-control-allow-origin", "access_control-allow-origin"));
+	// Only ASCII letters are folded.
+	CHECK(!utils::equal_ascii_case_insensitive("@@@@@@@@[[[[", "````````{{{{"));
+	CHECK(!utils::equal_ascii_case_insensitive("\xc1\xc1\xc1\xc1\xc1\xc1\xc1\xc1", "\xe1\xe1\xe1\xe1\xe1\xe1\xe1\xe1"));
+}
+
+TEST_CASE("ascii_to_lowercase_8 matches ascii_to_lowercase") {
+	for (auto first_byte = 0; first_byte < 256; first_byte += 8) {
+		auto bytes = std::array<char, 8>{};
+		for (auto i = 0; i < 8; ++i) {
+			bytes[static_cast<std::size_t>(i)] = static_cast<char>(first_byte + i);
+		}
+		auto expected = bytes;
+		std::ranges::transform(expected, expected.begin(), utils::ascii_to_lowercase);
+		
+		auto const result = std::bit_cast<std::array<char, 8>>(
+			utils::ascii_to_lowercase_8(std::bit_cast<std::uint64_t>(bytes))
+		);
+		CHECK(result == expected);
+	}
+}
+
+TEST_CASE("find_header_by_name") {
+	auto const headers = std::vector<Header>{{"Content-Type", "text/html"}, {"TRANSFER-ENCODING", "chunked"}};
+	REQUIRE(algorithms::find_header_by_name(headers, "transfer-encoding"));
+	CHECK(algorithms::find_header_by_name(headers, "transfer-encoding")->value == "chunked");
+	CHECK(!algorithms::find_header_by_name(headers, "content-length"));
+}
+
+TEST_CASE("get_is_chunked_transfer_encoding") {
+	STATIC_REQUIRE(algorithms::get_is_chunked_transfer_encoding("chunked"));
+	CHECK(algorithms::get_is_chunked_transfer_encoding("Chunked"));
+	CHECK(algorithms::get_is_chunked_transfer_encoding("gzip, chunked "));
+	CHECK(algorithms::get_is_chunked_transfer_encoding("gzip,CHUNKED"));
+	CHECK(!algorithms::get_is_chunked_transfer_encoding("chunked, gzip"));
+	CHECK(!algorithms::get_is_chunked_transfer_encoding("gzip"));
+	CHECK(!algorithms::get_is_chunked_transfer_encoding(""));
+	CHECK(!algorithms::get_is_chunked_transfer_encoding(" , "));
+}
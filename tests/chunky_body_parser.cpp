@@ -58,3 +58,56 @@ TEST_CASE("Chunked http body parser, invalid input") {
 TEST_CASE("Chunked http body parser, empty input") {
     test_chunky_body_parser("", "");
 }
+
+TEST_CASE("Chunked http body parser, extensions and trailers") {
+    constexpr auto input = 
+        "5;name=value\r\n"
+        "Hello\r\n"
+        "7 ; flag ;quoted=\"a;b\"\r\n"
+        ", world\r\n"
+        "0\r\n"
+        "Checksum: abc\r\n"
+        "Expires: never\r\n"
+        "\r\n"
+        "HTTP/1.1 200 OK\r\n"sv;
+    auto const input_data = utils::string_to_data<std::byte>(input);
+
+    for (auto const packet_size : std::array<std::size_t, 4>{1, 3, 16, 1024})
+    {
+        auto parser = algorithms::ChunkyBodyParser{};
+
+        for (auto pos = std::size_t{};; pos += packet_size)
+        {
+            REQUIRE(pos < input_data.size());
+            auto const packet = input_data.subspan(pos, std::min(packet_size, input_data.size() - pos));
+            if (auto const result = parser.parse_new_data(packet)) {
+                CHECK(utils::data_to_string(std::span{*result}) == "Hello, world");
+                CHECK(parser.get_trailers_string() == "Checksum: abc\r\nExpires: never");
+                CHECK(std::ranges::equal(
+                    algorithms::parse_chunk_extensions(parser.get_chunk_extensions_string()), 
+                    std::array{
+                        algorithms::ChunkExtension{.name="name", .value="value"}, 
+                        algorithms::ChunkExtension{.name="flag", .value=""}, 
+                        algorithms::ChunkExtension{.name="quoted", .value="a;b"}
+                    }
+                ));
+                // The message ends right before the next response.
+                CHECK(pos + parser.get_end_offset() == input.find("HTTP/1.1"));
+                break;
+            }
+        }
+    }
+}
+
+TEST_CASE("Chunked http body parser, bare line feeds") {
+    test_chunky_body_parser("5\nHello\n0\n\n"sv, "Hello"sv);
+}
+
+TEST_CASE("Chunked http body parser, malformed framing") {
+    // Chunk data that is longer than its size.
+    REQUIRE_THROWS_AS(test_chunky_body_parser("3\r\nHello\r\n0\r\n\r\n"sv, ""), errors::ResponseParsingFailed);
+    // A chunk size that does not fit in std::size_t.
+    REQUIRE_THROWS_AS(test_chunky_body_parser("100000000000000000\r\n"sv, ""), errors::ResponseParsingFailed);
+    // Garbage after the chunk size.
+    REQUIRE_THROWS_AS(test_chunky_body_parser("5 x\r\nHello\r\n0\r\n\r\n"sv, ""), errors::ResponseParsingFailed);
+}
@@ -0,0 +1,181 @@
+#include "testing_header.hpp"
+
+// The decoded body is identity_body repeated 20 times.
+constexpr auto identity_body = "This is a test\nLine two\n\nAnother line!!!"sv;
+constexpr auto identity_body_repetitions = std::size_t{20};
+
+constexpr auto gzip_body = 
+	"\x1f\x8b\x08\x00\x00\x00\x00\x00\x02\x03\x0b\xc9\xc8\x2c\x56\x00\xa2\x44\x85\x92\xd4\xe2\x12\x2e\x9f\xcc"
+	"\xbc\x54\x85\x92\xf2\x7c\x2e\x2e\xc7\xbc\xfc\x92\x8c\xd4\x22\x85\x1c\xa0\x88\xa2\xa2\x62\xc8\xa8\xba\x51"
+	"\x75\x23\x50\x1d\x00\x6f\xca\x82\x15\x20\x03\x00\x00"sv;
+constexpr auto zlib_wrapped_deflate_body = 
+	"\x78\x9c\x0b\xc9\xc8\x2c\x56\x00\xa2\x44\x85\x92\xd4\xe2\x12\x2e\x9f\xcc\xbc\x54\x85\x92\xf2\x7c\x2e\x2e"
+	"\xc7\xbc\xfc\x92\x8c\xd4\x22\x85\x1c\xa0\x88\xa2\xa2\x62\xc8\xa8\xba\x51\x75\x23\x50\x1d\x00\x93\x27\x05"
+	"\x64"sv;
+constexpr auto raw_deflate_body = 
+	"\x0b\xc9\xc8\x2c\x56\x00\xa2\x44\x85\x92\xd4\xe2\x12\x2e\x9f\xcc\xbc\x54\x85\x92\xf2\x7c\x2e\x2e\xc7\xbc"
+	"\xfc\x92\x8c\xd4\x22\x85\x1c\xa0\x88\xa2\xa2\x62\xc8\xa8\xba\x51\x75\x23\x50\x1d\x00"sv;
+constexpr auto brotli_body = 
+	"\x1b\x1f\x03\x00\xc4\x39\xd7\x2d\x49\x5b\x5f\x29\x0b\x86\xc1\xd9\xc3\x85\x27\x30\x0d\xf5\x96\x96\x86\x7a"
+	"\x81\xef\x66\xfc\x82\x9a\x35\xf3\x2f\x90\x36\x59\x3c\xb3\x96\x64\x01"sv;
+
+constexpr auto chunk_sizes_to_test = std::array<std::size_t, 4>{1, 8, 32, 512};
+
+[[nodiscard]]
+std::string get_decoded_body() {
+	auto result = std::string{};
+	for (auto i = std::size_t{}; i < identity_body_repetitions; ++i) {
+		result += identity_body;
+	}
+	return result;
+}
+
+[[nodiscard]]
+std::string to_chunked_body(std::string_view const body) {
+	auto result = std::string{};
+	for (auto pos = std::size_t{}; pos < body.size(); pos += 16) {
+		auto const chunk = body.substr(pos, 16);
+		result += std::format("{:X}\r\n", chunk.size());
+		result += chunk;
+		result += "\r\n";
+	}
+	return result += "0\r\n\r\n";
+}
+
+[[nodiscard]]
+algorithms::ParsedResponse parse_in_chunks(algorithms::ResponseParser& parser, std::string_view const input, std::size_t const chunk_size) {
+	for (auto pos = std::size_t{}; pos < input.size(); pos += chunk_size) {
+		if (auto result = parser.parse_new_data(utils::string_to_data<std::byte>(input.substr(pos, chunk_size)))) {
+			return *std::move(result);
+		}
+	}
+	FAIL("The parser did not reach the end of the response.");
+	return {};
+}
+
+void test_content_decoding(ContentEncoding const encoding, std::string_view const encoded_body) {
+	if (!get_is_content_encoding_supported(encoding)) {
+		WARN(std::format("The {} content encoding is not supported by this build.", content_encoding_to_string(encoding)));
+		return;
+	}
+
+	auto const decoded_body = get_decoded_body();
+	
+	auto const identity_input = std::format(
+		"HTTP/1.1 200 OK\r\nContent-Encoding: {}\r\nContent-Length: {}\r\n\r\n{}", 
+		content_encoding_to_string(encoding), encoded_body.size(), encoded_body
+	);
+	auto const chunked_input = std::format(
+		"HTTP/1.1 200 OK\r\nContent-Encoding: {}\r\nTransfer-Encoding: chunked\r\n\r\n{}", 
+		content_encoding_to_string(encoding), to_chunked_body(encoded_body)
+	);
+
+	for (auto const& input : {identity_input, chunked_input}) {
+		for (auto const chunk_size : chunk_sizes_to_test) {
+			auto last_body_size_so_far = std::size_t{};
+			auto last_encoded_body_size_so_far = std::size_t{};
+			
+			auto callbacks = algorithms::ResponseCallbacks{
+				.handle_raw_progress{},
+				.handle_headers{},
+				.handle_body_progress = [&](ResponseProgressBody& progress) {
+					// Progress is reported in decoded data.
+					CHECK(utils::data_to_string(progress.body_data_so_far) == std::string_view{decoded_body}.substr(0, progress.body_size_so_far));
+					CHECK(progress.encoded_body_size_so_far >= last_encoded_body_size_so_far);
+					last_body_size_so_far = progress.body_size_so_far;
+					last_encoded_body_size_so_far = progress.encoded_body_size_so_far;
+				},
+				.handle_body_data{},
+				.handle_finish{},
+				.handle_stop{}
+			};
+			auto parser = algorithms::ResponseParser{callbacks, {.is_decoding_content = true}};
+			auto const result = parse_in_chunks(parser, input, chunk_size);
+
+			CHECK(utils::data_to_string(std::span{result.body_data}) == decoded_body);
+			CHECK(result.body_size == decoded_body.size());
+			CHECK(result.encoded_body_size == encoded_body.size());
+			CHECK(last_body_size_so_far == decoded_body.size());
+			CHECK(last_encoded_body_size_so_far == encoded_body.size());
+		}
+	}
+
+	// The decoded body is passed to a body sink.
+	auto sunk_body = std::string{};
+	auto callbacks = algorithms::ResponseCallbacks{
+		.handle_raw_progress{},
+		.handle_headers{},
+		.handle_body_progress{},
+		.handle_body_data = [&](std::span<std::byte const> const data) {
+			sunk_body += utils::data_to_string(data);
+		},
+		.handle_finish{},
+		.handle_stop{}
+	};
+	auto parser = algorithms::ResponseParser{callbacks, {.is_decoding_content = true}};
+	auto const result = parse_in_chunks(parser, chunked_input, 8);
+	CHECK(result.body_data.empty());
+	CHECK(result.body_size == decoded_body.size());
+	CHECK(sunk_body == decoded_body);
+}
+
+TEST_CASE("Gzip content decoding") {
+	test_content_decoding(ContentEncoding::Gzip, gzip_body);
+}
+TEST_CASE("Deflate content decoding") {
+	test_content_decoding(ContentEncoding::Deflate, zlib_wrapped_deflate_body);
+}
+TEST_CASE("Raw deflate content decoding") {
+	test_content_decoding(ContentEncoding::Deflate, raw_deflate_body);
+}
+TEST_CASE("Brotli content decoding") {
+	test_content_decoding(ContentEncoding::Brotli, brotli_body);
+}
+
+TEST_CASE("Content decoding of concatenated gzip members") {
+	if (!get_is_content_encoding_supported(ContentEncoding::Gzip)) {
+		return;
+	}
+	auto decoder = algorithms::ContentDecoder{ContentEncoding::Gzip};
+	auto decoded = std::string{};
+	auto const output = algorithms::BodySink{[&](std::span<std::byte const> const data) {
+		decoded += utils::data_to_string(data);
+	}};
+	decoder.decode(utils::string_to_data<std::byte>(std::string{gzip_body} += gzip_body), output);
+	CHECK(decoder.get_is_finished());
+	CHECK(decoded == get_decoded_body() + get_decoded_body());
+}
+
+TEST_CASE("Content decoding is opt-in") {
+	auto const input = std::format(
+		"HTTP/1.1 200 OK\r\nContent-Encoding: gzip\r\nContent-Length: {}\r\n\r\n{}", 
+		gzip_body.size(), gzip_body
+	);
+	auto parser = algorithms::ResponseParser{};
+	auto const result = parse_in_chunks(parser, input, 8);
+	CHECK(utils::data_to_string(std::span{result.body_data}) == gzip_body);
+	CHECK(result.encoded_body_size == gzip_body.size());
+}
+
+TEST_CASE("Content decoding of invalid or truncated data") {
+	if (!get_is_content_encoding_supported(ContentEncoding::Gzip)) {
+		return;
+	}
+	auto const parse = [](std::string_view const body) {
+		auto const input = std::format(
+			"HTTP/1.1 200 OK\r\nContent-Encoding: gzip\r\nContent-Length: {}\r\n\r\n{}", body.size(), body
+		);
+		auto parser = algorithms::ResponseParser{algorithms::ResponseParsingOptions{.is_decoding_content = true}};
+		return parse_in_chunks(parser, input, 8);
+	};
+	CHECK_THROWS_AS(parse("This is not gzip data"), errors::ResponseParsingFailed);
+	CHECK_THROWS_AS(parse(gzip_body.substr(0, gzip_body.size()/2)), errors::ResponseParsingFailed);
+}
+
+TEST_CASE("Parsing content encodings") {
+	CHECK(algorithms::parse_content_encoding("gzip") == ContentEncoding::Gzip);
+	CHECK(algorithms::parse_content_encoding("X-GZIP") == ContentEncoding::Gzip);
+	CHECK(algorithms::parse_content_encoding("Br") == ContentEncoding::Brotli);
+	CHECK(algorithms::parse_content_encoding("gzip, br") == std::nullopt);
+	CHECK(algorithms::get_accept_encoding_header_value().find("identity") == std::string::npos);
+}
@@ -0,0 +1,130 @@
+#include "testing_header.hpp"
+
+[[nodiscard]]
+std::string get_compressible_text() {
+	auto result = std::string{};
+	for (auto i = 0; i < 5000; ++i) {
+		result += std::format("{{\"id\": {}, \"name\": \"event\", \"value\": {}}}\n", i, i % 17);
+	}
+	return result;
+}
+
+void test_content_encoding_round_trip(ContentEncoding const encoding, std::optional<int> const level) {
+	if (!get_is_content_compression_supported(encoding)) {
+		WARN(std::format("Compressing with the {} content encoding is not supported by this build.", content_encoding_to_string(encoding)));
+		return;
+	}
+
+	auto const text = get_compressible_text();
+
+	auto encoded = std::string{};
+	auto encoder = algorithms::ContentEncoder{encoding, level};
+	auto const encoder_output = algorithms::BodySink{[&](std::span<std::byte const> const data) {
+		encoded += utils::data_to_string(data);
+	}};
+	// Encode in uneven pieces.
+	for (auto pos = std::size_t{}; pos < text.size(); pos += 1000) {
+		encoder.encode(utils::string_to_data<std::byte>(std::string_view{text}.substr(pos, 1000)), encoder_output);
+	}
+	encoder.finish(encoder_output);
+	
+	CHECK(encoded.size() < text.size()/4);
+
+	auto decoded = std::string{};
+	auto decoder = algorithms::ContentDecoder{encoding};
+	decoder.decode(utils::string_to_data<std::byte>(encoded), [&](std::span<std::byte const> const data) {
+		decoded += utils::data_to_string(data);
+	});
+	CHECK(decoder.get_is_finished());
+	CHECK(decoded == text);
+}
+
+TEST_CASE("Gzip content encoding") {
+	test_content_encoding_round_trip(ContentEncoding::Gzip, {});
+	test_content_encoding_round_trip(ContentEncoding::Gzip, 1);
+	test_content_encoding_round_trip(ContentEncoding::Gzip, 9);
+}
+TEST_CASE("Deflate content encoding") {
+	test_content_encoding_round_trip(ContentEncoding::Deflate, {});
+}
+TEST_CASE("Zstd content encoding") {
+	test_content_encoding_round_trip(ContentEncoding::Zstd, {});
+	test_content_encoding_round_trip(ContentEncoding::Zstd, 19);
+}
+
+TEST_CASE("Invalid content encoder arguments") {
+	CHECK_THROWS_AS(algorithms::ContentEncoder{ContentEncoding::Brotli}, std::invalid_argument);
+	// Identity must not be sent as a Content-Encoding.
+	CHECK_FALSE(get_is_content_compression_supported(ContentEncoding::Identity));
+	CHECK_THROWS_AS(algorithms::ContentEncoder{ContentEncoding::Identity}, std::invalid_argument);
+	if (get_is_content_compression_supported(ContentEncoding::Gzip)) {
+		CHECK_THROWS_AS((algorithms::ContentEncoder{ContentEncoding::Gzip, 10}), std::invalid_argument);
+	}
+	if (get_is_content_compression_supported(ContentEncoding::Zstd)) {
+		CHECK_NOTHROW(algorithms::ContentEncoder{ContentEncoding::Zstd, 1});
+		CHECK_NOTHROW(algorithms::ContentEncoder{ContentEncoding::Zstd, 22});
+		CHECK_THROWS_AS((algorithms::ContentEncoder{ContentEncoding::Zstd, 0}), std::invalid_argument);
+		CHECK_THROWS_AS((algorithms::ContentEncoder{ContentEncoding::Zstd, -1}), std::invalid_argument);
+		CHECK_THROWS_AS((algorithms::ContentEncoder{ContentEncoding::Zstd, 23}), std::invalid_argument);
+	}
+}
+
+TEST_CASE("Compressing body source") {
+	for (auto const encoding : {ContentEncoding::Gzip, ContentEncoding::Zstd}) {
+		if (!get_is_content_compression_supported(encoding)) {
+			continue;
+		}
+		auto const text = get_compressible_text();
+
+		// The source produces small pieces, and the compressed data is read in smaller pieces still.
+		auto position = std::size_t{};
+		auto const text_source = [&](std::span<std::byte> const buffer) {
+			auto const size = std::min({std::size_t{3000}, buffer.size(), text.size() - position});
+			std::ranges::copy(utils::string_to_data<std::byte>(std::string_view{text}.substr(position, size)), buffer.begin());
+			position += size;
+			return size;
+		};
+		auto compressing_source = algorithms::make_compressing_body_source(text_source, encoding);
+
+		auto encoded = std::string{};
+		auto buffer = std::array<std::byte, 100>();
+		while (auto const size = compressing_source(buffer)) {
+			REQUIRE(size <= buffer.size());
+			encoded += utils::data_to_string(std::span{buffer}.first(size));
+		}
+		// The end of the compressed data stays the end.
+		CHECK(compressing_source(buffer) == 0);
+		CHECK(encoded.size() < text.size()/4);
+
+		auto decoded = std::string{};
+		auto decoder = algorithms::ContentDecoder{encoding};
+		decoder.decode(utils::string_to_data<std::byte>(encoded), [&](std::span<std::byte const> const data) {
+			decoded += utils::data_to_string(data);
+		});
+		CHECK(decoder.get_is_finished());
+		CHECK(decoded == text);
+	}
+}
+
+TEST_CASE("Compressing body source with an empty body") {
+	if (!get_is_content_compression_supported(ContentEncoding::Gzip)) {
+		return;
+	}
+	auto compressing_source = algorithms::make_compressing_body_source([](std::span<std::byte>) { return std::size_t{}; }, ContentEncoding::Gzip);
+
+	auto encoded = std::string{};
+	auto buffer = std::array<std::byte, 4096>();
+	while (auto const size = compressing_source(buffer)) {
+		encoded += utils::data_to_string(std::span{buffer}.first(size));
+	}
+	// An empty gzip member still has a header and a trailer.
+	CHECK_FALSE(encoded.empty());
+
+	auto decoded = std::string{};
+	auto decoder = algorithms::ContentDecoder{ContentEncoding::Gzip};
+	decoder.decode(utils::string_to_data<std::byte>(encoded), [&](std::span<std::byte const> const data) {
+		decoded += utils::data_to_string(data);
+	});
+	CHECK(decoder.get_is_finished());
+	CHECK(decoded.empty());
+}
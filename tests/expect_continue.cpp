@@ -0,0 +1,80 @@
+#include "testing_header.hpp"
+
+TEST_CASE("Status code of the response to a request that expects 100 Continue") {
+	using algorithms::get_is_continue_response;
+
+	CHECK(get_is_continue_response("HTTP/1.1 100 Continue\r\n\r\n") == true);
+	CHECK(get_is_continue_response("HTTP/1.1 100") == true);
+	CHECK(get_is_continue_response("HTTP/1.1 103 Early Hints\r\n") == true);
+
+	CHECK(get_is_continue_response("HTTP/1.1 413 Content Too Large\r\n") == false);
+	CHECK(get_is_continue_response("HTTP/1.1 417 Expectation Failed\r\n") == false);
+	CHECK(get_is_continue_response("HTTP/1.1 200 OK\r\n") == false);
+
+	// The status code has not been received completely yet.
+	CHECK_FALSE(get_is_continue_response(""));
+	CHECK_FALSE(get_is_continue_response("HTT"));
+	CHECK_FALSE(get_is_continue_response("HTTP/1.1"));
+	CHECK_FALSE(get_is_continue_response("HTTP/1.1 10"));
+
+	// Data that is not an HTTP response is left to the response parser.
+	CHECK(get_is_continue_response("HTTP/1.1 abc") == true);
+	CHECK(get_is_continue_response("garbage that is not a response") == true);
+}
+
+/*
+	Returns the pieces of data that the request would send.
+*/
+[[nodiscard]]
+std::vector<std::string> get_sent_pieces(Request&& request) {
+	auto pieces = std::vector<std::string>();
+	std::move(request).serialize([&](std::span<std::byte const> const data) { pieces.emplace_back(utils::data_to_string(data)); });
+	return pieces;
+}
+[[nodiscard]]
+std::vector<std::string> get_sent_pieces(PreparedRequest const& request) {
+	auto pieces = std::vector<std::string>();
+	request.serialize([&](std::span<std::byte const> const data) { pieces.emplace_back(utils::data_to_string(data)); });
+	return pieces;
+}
+
+TEST_CASE("Requests that expect 100 Continue") {
+	auto const expected_pieces = std::vector<std::string>{
+		"POST /upload HTTP/1.1\r\nHost: example.com\r\nTransfer-Encoding: identity\r\nContent-Length: 3\r\nExpect: 100-continue\r\n\r\n",
+		"abc",
+	};
+
+	SECTION("The body is sent separately from the headers") {
+		CHECK(get_sent_pieces(post("http://example.com/upload").set_body("abc"sv).enable_expect_continue()) == expected_pieces);
+		CHECK(get_sent_pieces(post("http://example.com/upload").set_body("abc"sv).enable_expect_continue().prepare()) == expected_pieces);
+	}
+	SECTION("A request without a body expects nothing") {
+		auto const expected_request = std::vector<std::string>{"POST /upload HTTP/1.1\r\nHost: example.com\r\n\r\n"};
+		CHECK(get_sent_pieces(post("http://example.com/upload").enable_expect_continue()) == expected_request);
+
+		auto const prepared_request = post("http://example.com/upload").set_body("abc"sv).enable_expect_continue().prepare();
+		CHECK(get_sent_pieces(prepared_request) == expected_pieces);
+		auto pieces = std::vector<std::string>();
+		prepared_request.serialize(
+			[&](std::span<std::byte const> const data) { pieces.emplace_back(utils::data_to_string(data)); },
+			{}, std::span<std::byte const>{}
+		);
+		CHECK(pieces == expected_request);
+	}
+	SECTION("A streamed body") {
+		auto is_body_read = false;
+		auto const body_source = [&is_body_read](std::span<std::byte> const buffer) {
+			if (is_body_read) {
+				return std::size_t{};
+			}
+			is_body_read = true;
+			buffer[0] = std::byte{'x'};
+			return std::size_t{1};
+		};
+		CHECK(get_sent_pieces(post("http://example.com/upload").set_body_stream(body_source).enable_expect_continue()) == std::vector<std::string>{
+			"POST /upload HTTP/1.1\r\nHost: example.com\r\nTransfer-Encoding: chunked\r\nExpect: 100-continue\r\n\r\n",
+			"1\r\nx\r\n",
+			"0\r\n\r\n",
+		});
+	}
+}
@@ -0,0 +1,21 @@
+#include "testing_header.hpp"
+
+TEST_CASE("Header line validation") {
+	STATIC_REQUIRE(utils::is_valid_header_line("Accept: application/json"));
+	STATIC_REQUIRE(utils::is_valid_header_line("X-Custom-Header:value"));
+	STATIC_REQUIRE(utils::is_valid_header_line("Empty:"));
+	STATIC_REQUIRE(utils::is_valid_header_line("Tabbed:\tvalue with\ttabs"));
+	STATIC_REQUIRE(!utils::is_valid_header_line("No colon"));
+	STATIC_REQUIRE(!utils::is_valid_header_line(": no name"));
+	STATIC_REQUIRE(!utils::is_valid_header_line("Bad name: value"));
+	STATIC_REQUIRE(!utils::is_valid_header_line("Name: two\r\nLines: here"));
+	STATIC_REQUIRE(!utils::is_valid_header_line("Name: new\nline"));
+}
+
+TEST_CASE("Compile time header blocks") {
+	constexpr auto block = utils::make_header_block<"Accept: application/json", "User-Agent: svc/1.0">();
+	STATIC_REQUIRE(std::string_view{block.data(), block.size()} == "Accept: application/json\r\nUser-Agent: svc/1.0\r\n");
+
+	constexpr auto single = utils::make_header_block<"A: b">();
+	STATIC_REQUIRE(std::string_view{single.data(), single.size()} == "A: b\r\n");
+}
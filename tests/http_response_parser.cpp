@@ -2,29 +2,22 @@
 
 void test_response_parser(std::string_view const input, algorithms::ParsedResponse const& expected_result) 
 {
-	auto const response_data = utils::string_to_data<std::byte>(input);
-
+	for (auto const is_parsing_headers_lazily : {false, true})
 	for (std::size_t const packet_size : {static_cast<std::size_t>(1), static_cast<std::size_t>(8), static_cast<std::size_t>(32), static_cast<std::size_t>(128), static_cast<std::size_t>(512), static_cast<std::size_t>(2048)})
 	{
-		auto parser = algorithms::ResponseParser{};
-
-		for (auto pos = std::size_t{};; pos += packet_size) 
-		{
-			if (auto const result = parser.parse_new_data(
-					response_data.subspan(pos, std::min(response_data.size() - pos, packet_size))
-				))
-			{
-				REQUIRE(result == expected_result);
-				// test_utils::check_http_response(result, expected_result);
-				break;
-			}
+		// The server closes the connection after the response, which ends bodies without a length.
+		auto const result = test_utils::parse_in_packets(input, packet_size, {.is_parsing_headers_lazily = is_parsing_headers_lazily});
+		REQUIRE(result);
+		if (is_parsing_headers_lazily) {
+			CHECK(std::ranges::equal(result->get_headers(), expected_result.get_headers()));
 		}
+		REQUIRE(result == expected_result);
 	}
 }
 
-utils::DataVector string_to_data_vector(std::string_view const string) {
+utils::pmr::DataVector string_to_data_vector(std::string_view const string) {
 	auto const data = utils::string_to_data<std::byte>(string);
-	return utils::DataVector(data.begin(), data.end());
+	return utils::pmr::DataVector(data.begin(), data.end());
 }
 
 TEST_CASE("Http response parser, conforming line endings") {
@@ -136,3 +129,267 @@ TEST_CASE("Http response parser, chunked transfer encoding") {
 
 	test_response_parser(input, expected_result);
 }
+
+TEST_CASE("Http response parser, partial content") {
+	auto const expected_headers_string = std::string{
+		"HTTP/1.1 206 Partial Content\r\n"
+		"Content-Range: bytes 100-109/1234\r\n"
+		"ETag: \"abc\"\r\n"
+		"Content-Length: 10"
+	};
+	constexpr auto expected_body_string = "0123456789";
+
+	auto parser = algorithms::ResponseParser{};
+	auto const input = expected_headers_string + "\r\n\r\n" + expected_body_string;
+	auto result = parser.parse_new_data(utils::string_to_data<std::byte>(input));
+	REQUIRE(result);
+
+	auto const response = Response{*std::move(result), {}, {}};
+	CHECK(response.get_status_code() == StatusCode::PartialContent);
+	CHECK(response.get_body_string() == expected_body_string);
+	CHECK(response.get_content_range() == algorithms::ContentRange{
+		.range = algorithms::ByteRange{.first = 100, .last = 109},
+		.complete_length = 1234,
+	});
+	CHECK(algorithms::get_if_range_validator(response) == "\"abc\"");
+}
+
+class CountingMemoryResource : public std::pmr::memory_resource {
+public:
+	std::size_t number_of_allocations{};
+	std::size_t bytes_allocated{};
+
+private:
+	void* do_allocate(std::size_t const bytes, std::size_t const alignment) override {
+		++number_of_allocations;
+		bytes_allocated += bytes;
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+	void do_deallocate(void* const pointer, std::size_t const bytes, std::size_t const alignment) override {
+		bytes_allocated -= bytes;
+		std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+	}
+	bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override {
+		return this == &other;
+	}
+};
+
+TEST_CASE("Http response parser, response metadata is allocated from one arena") {
+	auto headers_string = std::string{"HTTP/1.1 200 An unusually long status message"};
+	for (auto i = 0; i < 20; ++i) {
+		headers_string += std::format("\r\nX-Header-{}: {}", i, i);
+	}
+	auto const input = headers_string + "\r\nContent-Length: 4\r\n\r\nbody";
+
+	auto memory_resource = CountingMemoryResource{};
+	auto result = std::optional<algorithms::ParsedResponse>{};
+	{
+		auto parser = algorithms::ResponseParser{algorithms::ResponseParsingOptions{.memory_resource = &memory_resource}};
+		result = parser.parse_new_data(utils::string_to_data<std::byte>(input));
+		REQUIRE(result);
+		CHECK(result->status_line.status_message == "An unusually long status message");
+		CHECK(result->get_headers().size() == 21);
+		CHECK(utils::data_to_string(std::span{result->body_data}) == "body");
+		
+		// One allocation for the receive buffer, one for the arena, 
+		// which contains all metadata, and one for the body.
+		CHECK(memory_resource.number_of_allocations == 3);
+	}
+	// Assigning a response with another memory resource frees the old one.
+	*result = algorithms::ParsedResponse{std::pmr::new_delete_resource()};
+	CHECK(memory_resource.bytes_allocated == 0);
+}
+
+TEST_CASE("Http response parser, no arena without a memory resource") {
+	auto memory_resource = CountingMemoryResource{};
+	auto const previous_default_resource = std::pmr::set_default_resource(&memory_resource);
+	auto const restore_default_resource = utils::Cleanup{[&] { std::pmr::set_default_resource(previous_default_resource); }};
+
+	auto parser = algorithms::ResponseParser{};
+	auto const result = parser.parse_new_data(utils::string_to_data<std::byte>("HTTP/1.1 204 No Content\r\nServer: test\r\n\r\n"sv));
+	REQUIRE(result);
+	CHECK(result->get_headers().size() == 1);
+	// The metadata is allocated as it is needed, instead of in a block the size of an arena.
+	CHECK(memory_resource.bytes_allocated < 1024);
+}
+
+TEST_CASE("Http response parser, response buffers are reused") {
+	auto const body = std::string(1000, 'a');
+	auto const regular_input = std::format("HTTP/1.1 200 OK\r\nContent-Length: {}\r\n\r\n{}", body.size(), body);
+	auto const chunked_input = std::format("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n{:x}\r\n{}\r\n0\r\n\r\n", body.size(), body);
+
+	for (auto const& input : {regular_input, chunked_input}) {
+		auto memory_resource = CountingMemoryResource{};
+		auto buffers = ResponseBuffers{};
+
+		auto const parse = [&] {
+			auto parser = algorithms::ResponseParser{algorithms::ResponseParsingOptions{
+				.memory_resource = &memory_resource,
+				.response_buffers = &buffers,
+			}};
+			auto const data = utils::string_to_data<std::byte>(input);
+			for (auto pos = std::size_t{};; pos += 64) {
+				if (auto result = parser.parse_new_data(data.subspan(pos, std::min(data.size() - pos, std::size_t{64})))) {
+					return Response{*std::move(result), {}, {}};
+				}
+			}
+		};
+
+		buffers.recycle(parse());
+		auto const number_of_allocations = memory_resource.number_of_allocations;
+
+		for (auto i = 0; i < 3; ++i) {
+			auto response = parse();
+			CHECK(response.get_body_string() == body);
+			buffers.recycle(std::move(response));
+			CHECK(response.get_body().empty());
+		}
+		// Only the arena of each response is allocated, the buffers have already grown.
+		CHECK(memory_resource.number_of_allocations == number_of_allocations + 3);
+	}
+}
+
+TEST_CASE("Http response parser, segmented body") {
+	auto body = std::string{};
+	for (auto i = 0; i < 300; ++i) {
+		body += std::format("{},", i);
+	}
+	auto const regular_input = std::format("HTTP/1.1 200 OK\r\nContent-Length: {}\r\n\r\n{}", body.size(), body);
+	auto const chunked_input = std::format("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n{:x}\r\n{}\r\n{:x}\r\n{}\r\n0\r\n\r\n", 
+		body.size() / 2, body.substr(0, body.size() / 2), body.size() - body.size() / 2, body.substr(body.size() / 2));
+
+	constexpr auto segment_size = std::size_t{100};
+
+	for (auto const& input : {regular_input, chunked_input})
+	for (auto const packet_size : std::array<std::size_t, 4>{1, 7, 64, 4096})
+	{
+		auto result = test_utils::parse_in_packets(input, packet_size, {.body_segment_size = segment_size});
+		REQUIRE(result);
+
+		auto response = Response{*std::move(result), {}, {}};
+		CHECK(response.get_body().empty());
+		CHECK(response.get_body_size() == body.size());
+
+		auto const segments = response.get_body_segments();
+		CHECK(static_cast<std::size_t>(std::ranges::distance(segments)) == (body.size() + segment_size - 1) / segment_size);
+		CHECK(std::ranges::all_of(segments | std::views::take(std::ranges::distance(segments) - 1), 
+			[](auto const segment) { return segment.size() == segment_size; }));
+		
+		response.flatten_body();
+		CHECK(response.get_body_string() == body);
+		CHECK(std::ranges::empty(response.get_body_segments()));
+	}
+}
+
+TEST_CASE("Http response parser, chunk extensions and trailers") {
+	constexpr auto input = 
+		"HTTP/1.1 200 OK\r\n"
+		"Transfer-Encoding: chunked\r\n"
+		"Trailer: Checksum\r\n"
+		"\r\n"
+		"4;part=1\r\nbody\r\n"
+		"0\r\n"
+		"Checksum: 1234\r\n"
+		"\r\n"sv;
+
+	for (auto const body_segment_size : {std::size_t{}, std::size_t{2}}) {
+		auto parser = algorithms::ResponseParser{algorithms::ResponseParsingOptions{.body_segment_size = body_segment_size}};
+		auto result = parser.parse_new_data(utils::string_to_data<std::byte>(input));
+		REQUIRE(result);
+
+		auto response = Response{*std::move(result), {}, {}};
+		response.flatten_body();
+		CHECK(response.get_body_string() == "body");
+		CHECK(response.get_trailer_value("checksum") == "1234");
+		CHECK(response.get_trailers().size() == 1);
+		CHECK(std::ranges::equal(response.get_chunk_extensions(), std::array{algorithms::ChunkExtension{.name="part", .value="1"}}));
+	}
+}
+
+TEST_CASE("Http response parser, responses without a body") {
+	for (auto const packet_size : std::array<std::size_t, 3>{1, 5, 1024}) {
+		// The parser must not wait for a body that is never sent.
+		auto const head_result = test_utils::parse_in_packets(
+			"HTTP/1.1 200 OK\r\nContent-Length: 1234\r\n\r\n", packet_size, {.is_response_to_head_request = true}
+		);
+		REQUIRE(head_result);
+		CHECK(head_result->body_data.empty());
+
+		for (auto const status_line : {"HTTP/1.1 204 No Content"sv, "HTTP/1.1 304 Not Modified"sv}) {
+			auto status_parser = algorithms::ResponseParser{};
+			auto const result = status_parser.parse_new_data(utils::string_to_data<std::byte>(
+				std::format("{}\r\nContent-Length: 10\r\nTransfer-Encoding: chunked\r\n\r\n", status_line)
+			));
+			REQUIRE(result);
+			CHECK(result->body_data.empty());
+		}
+	}
+}
+
+TEST_CASE("Http response parser, interim responses") {
+	constexpr auto input = 
+		"HTTP/1.1 100 Continue\r\n\r\n"
+		"HTTP/1.1 103 Early Hints\r\n"
+		"Link: </style.css>; rel=preload\r\n\r\n"
+		"HTTP/1.1 200 OK\r\n"
+		"Content-Length: 4\r\n\r\n"
+		"body"sv;
+
+	for (auto const packet_size : std::array<std::size_t, 4>{1, 7, 30, 1024})
+	for (auto const body_segment_size : {std::size_t{}, std::size_t{3}})
+	{
+		auto result = test_utils::parse_in_packets(input, packet_size, {.body_segment_size = body_segment_size});
+		REQUIRE(result);
+		CHECK(result->status_line.status_code == StatusCode::Ok);
+		CHECK(result->headers_string == "HTTP/1.1 200 OK\r\nContent-Length: 4");
+		CHECK(result->find_header("Link") == nullptr);
+		CHECK((body_segment_size ? result->body_segments.flatten() : result->body_data) == string_to_data_vector("body"));
+	}
+}
+
+TEST_CASE("Http response parser, body ended by closing the connection") {
+	for (auto const packet_size : std::array<std::size_t, 3>{1, 7, 1024}) {
+		auto const result = test_utils::parse_in_packets("HTTP/1.0 200 OK\r\nServer: old\r\n\r\nThe whole body", packet_size);
+		REQUIRE(result);
+		CHECK(utils::data_to_string(std::span{result->body_data}) == "The whole body");
+		CHECK(result->body_size == 14);
+
+		// A transfer coding other than chunked also means that the body ends when the connection is closed.
+		auto const unknown_coding_result = test_utils::parse_in_packets("HTTP/1.1 200 OK\r\nTransfer-Encoding: x-custom\r\nContent-Length: 1\r\n\r\nabc", packet_size);
+		REQUIRE(unknown_coding_result);
+		CHECK(utils::data_to_string(std::span{unknown_coding_result->body_data}) == "abc");
+
+		// A body with a length that is cut short is incomplete.
+		CHECK_FALSE(test_utils::parse_in_packets("HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\nabc", packet_size));
+		CHECK_FALSE(test_utils::parse_in_packets("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nabc\r\n", packet_size));
+	}
+}
+
+TEST_CASE("Http response parser, invalid Content-Length") {
+	CHECK_THROWS_AS(test_utils::parse_in_packets("HTTP/1.1 200 OK\r\nContent-Length: ten\r\n\r\n", 1024), errors::ResponseParsingFailed);
+}
+
+TEST_CASE("Http response parser, lazily parsed headers are accessed from several threads") {
+	auto parser = algorithms::ResponseParser{algorithms::ResponseParsingOptions{.is_parsing_headers_lazily = true}};
+	auto const result = parser.parse_new_data(utils::string_to_data<std::byte>(
+		"HTTP/1.1 200 OK\r\nContent-Length: 4\r\nContent-Type: text/plain\r\nServer: test\r\n\r\nbody"sv
+	));
+	REQUIRE(result);
+
+	auto const expected_headers = std::vector<Header>{
+		Header{.name="content-length", .value="4"},
+		Header{.name="content-type", .value="text/plain"},
+		Header{.name="server", .value="test"},
+	};
+	auto threads = std::vector<std::jthread>();
+	auto are_headers_correct = std::array<bool, 8>{};
+	for (auto& is_correct : are_headers_correct) {
+		threads.emplace_back([&result, &expected_headers, &is_correct] {
+			auto const server = result->find_header("server");
+			is_correct = std::ranges::equal(result->get_headers(), expected_headers) && 
+				server && server->value == "test";
+		});
+	}
+	threads.clear();
+	CHECK(std::ranges::all_of(are_headers_correct, std::identity{}));
+}
@@ -95,11 +95,12 @@ void test_callbacks_full_input(
 			.handle_headers = [&](ResponseProgressHeaders& progress) {
 				CHECK(progress.get_status_line() == expected_result.status_line);
 				CHECK(progress.get_headers_string() == expected_result.headers_string);
-				CHECK(std::ranges::equal(progress.get_headers(), expected_result.headers));
+				CHECK(std::ranges::equal(progress.get_headers(), expected_result.get_headers()));
 			},
 			.handle_body_progress = [&](ResponseProgressBody& progress) {
 				CHECK(std::ranges::equal(progress.body_data_so_far, expected_body_data.first(progress.body_data_so_far.size())));
 			},
+			.handle_body_data{},
 			.handle_finish{},
 			.handle_stop{}
 		};
@@ -153,6 +154,7 @@ void test_callbacks_stopping_after_head(
 			.handle_body_progress = [&](ResponseProgressBody&) {
 				got_any_body = true;
 			},
+			.handle_body_data{},
 			.handle_finish{},
 			.handle_stop{}
 		};
@@ -172,3 +174,90 @@ TEST_CASE("Response parser with callbacks and chunked transfer, stopping after h
 TEST_CASE("Response parser with callbacks and identity transfer, stopping after head") {
 	test_callbacks_stopping_after_head(headers_string_identity_transfer, headers_identity_transfer, identity_body_string);
 }
+
+void test_body_sink(
+	std::string_view const headers_string, 
+	std::vector<Header> const& headers, 
+	std::string_view const body_string
+) {
+	auto const input_string = (std::string{headers_string} += header_body_separator) += body_string;
+
+	auto expected_result = algorithms::ParsedResponse{
+		test_utils::ok_status_line,
+		std::string{headers_string},
+		headers,
+	};
+	// The body is not kept, but its size is.
+	expected_result.body_size = expected_result.encoded_body_size = identity_body_string.size();
+
+	for (auto const chunk_size : chunk_sizes_to_test) {
+		auto sunk_body = std::string{};
+		auto got_headers = false;
+		auto last_body_size_so_far = std::size_t{};
+
+		auto response_callbacks = algorithms::ResponseCallbacks{
+			.handle_raw_progress = [&](ResponseProgressRaw& progress) {
+				// Only the latest packet is kept after the headers have been parsed.
+				if (got_headers) {
+					CHECK(progress.data.size() <= chunk_size);
+				}
+			},
+			.handle_headers = [&](ResponseProgressHeaders&) {
+				got_headers = true;
+			},
+			.handle_body_progress = [&](ResponseProgressBody& progress) {
+				CHECK(progress.body_data_so_far.empty());
+				CHECK(progress.body_size_so_far == sunk_body.size());
+				last_body_size_so_far = progress.body_size_so_far;
+			},
+			.handle_body_data = [&](std::span<std::byte const> const data) {
+				sunk_body += utils::data_to_string(data);
+			},
+			.handle_finish{},
+			.handle_stop{}
+		};
+		auto const result = parse_input_in_chunks(algorithms::ResponseParser{response_callbacks}, input_string, chunk_size);
+		CHECK(result == expected_result);
+		CHECK(sunk_body == identity_body_string);
+		CHECK(last_body_size_so_far == identity_body_string.size());
+	}
+}
+
+TEST_CASE("Response parser with body sink and chunked transfer") {
+	test_body_sink(headers_string_chunked_transfer, headers_chunked_transfer, chunked_body_string);
+}
+TEST_CASE("Response parser with body sink and identity transfer") {
+	test_body_sink(headers_string_identity_transfer, headers_identity_transfer, identity_body_string);
+}
+
+TEST_CASE("Response parser with body sink is moved while parsing") {
+	for (auto const& [headers_string, body_string] : {
+		std::pair{headers_string_chunked_transfer, std::string_view{chunked_body_string}}, 
+		std::pair{headers_string_identity_transfer, std::string_view{identity_body_string}}
+	}) {
+		auto const input_string = (std::string{headers_string} += header_body_separator) += body_string;
+		auto const input_data = utils::string_to_data<std::byte>(input_string);
+		auto const split_position = input_string.size() - body_string.size()/2;
+
+		auto sunk_body = std::string{};
+		auto response_callbacks = algorithms::ResponseCallbacks{
+			.handle_raw_progress{},
+			.handle_headers{},
+			.handle_body_progress{},
+			.handle_body_data = [&](std::span<std::byte const> const data) {
+				sunk_body += utils::data_to_string(data);
+			},
+			.handle_finish{},
+			.handle_stop{}
+		};
+
+		auto parser = algorithms::ResponseParser{response_callbacks};
+		REQUIRE_FALSE(parser.parse_new_data(input_data.first(split_position)));
+		
+		auto moved_parser = std::move(parser);
+		auto const result = moved_parser.parse_new_data(input_data.subspan(split_position));
+		REQUIRE(result);
+		CHECK(result->body_size == identity_body_string.size());
+		CHECK(sunk_body == identity_body_string);
+	}
+}
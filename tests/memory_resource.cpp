@@ -0,0 +1,118 @@
+#include "testing_header.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Counts the allocations from the global heap on the current thread.
+thread_local auto number_of_global_allocations = std::size_t{};
+
+} // namespace
+
+void* operator new(std::size_t const size) {
+	++number_of_global_allocations;
+	if (auto const pointer = std::malloc(size == 0 ? 1 : size)) {
+		return pointer;
+	}
+	throw std::bad_alloc{};
+}
+void operator delete(void* const pointer) noexcept {
+	std::free(pointer);
+}
+void operator delete(void* const pointer, std::size_t) noexcept {
+	std::free(pointer);
+}
+
+// The default memory resource uses the aligned forms.
+void* operator new(std::size_t const size, std::align_val_t const alignment) {
+	++number_of_global_allocations;
+	auto const alignment_value = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+	if (auto const pointer = std::aligned_alloc(alignment_value, (std::max(size, std::size_t{1}) + alignment_value - 1)/alignment_value*alignment_value)) {
+		return pointer;
+	}
+	throw std::bad_alloc{};
+}
+void operator delete(void* const pointer, std::align_val_t) noexcept {
+	std::free(pointer);
+}
+void operator delete(void* const pointer, std::size_t, std::align_val_t) noexcept {
+	std::free(pointer);
+}
+
+TEST_CASE("Receiving a response with a memory resource does not allocate from the global heap") {
+	constexpr auto input = std::string_view{
+		"HTTP/1.1 200 OK\r\n"
+		"Content-Type: text/plain; charset=UTF-8\r\n"
+		"Date: Sat, 19 Sep 2020 22:49:51 GMT\r\n"
+		"Transfer-Encoding: chunked\r\n"
+		"\r\n"
+		"1\r\nT\r\nE\r\nhis is a test\n\r\n"
+		"20\r\nA chunk that is a bit bigger....\r\n"
+		"0\r\n\r\n"
+	};
+
+	auto buffer = std::array<std::byte, 1 << 16>{};
+	auto memory_resource = std::pmr::monotonic_buffer_resource{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+
+	for (auto const packet_size : std::array<std::size_t, 4>{1, 7, 64, 1024}) {
+		memory_resource.release();
+		auto const number_of_global_allocations_before = number_of_global_allocations;
+		
+		auto result = test_utils::parse_in_packets(input, packet_size, {.memory_resource = &memory_resource});
+		REQUIRE(result);
+		auto const response = Response{
+			*std::move(result), 
+			utils::SharedString{"http://example.com/a/long/path/that/does/not/fit/in/a/small/string", &memory_resource}, 
+			{}
+		};
+		auto const content_type = response.get_header_value(KnownHeader::ContentType);
+		auto const date = response.get_header_value("date");
+		
+		CHECK(number_of_global_allocations == number_of_global_allocations_before);
+		CHECK(content_type == "text/plain; charset=UTF-8");
+		CHECK(date == "Sat, 19 Sep 2020 22:49:51 GMT");
+		CHECK(response.get_body_string() == "This is a test\nA chunk that is a bit bigger....");
+	}
+}
+
+TEST_CASE("Building and serializing a request with a memory resource does not allocate from the global heap") {
+	auto buffer = std::vector<std::byte>(1 << 18);
+	auto memory_resource = std::pmr::monotonic_buffer_resource{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+
+	auto const long_value = std::string(200, 'v');
+	auto const body = std::string(20'000, 'b');
+
+	for (auto const is_body_set_first : {false, true}) {
+		memory_resource.release();
+
+		auto request = post("http://example.com/a/long/path/that/does/not/fit/in/a/small/string")
+			.add_header({.name="X-Before", .value=long_value})
+			.set_body(is_body_set_first ? std::string_view{body} : std::string_view{});
+		auto serialized_request = std::pmr::string{&memory_resource};
+		serialized_request.reserve(body.size() + 2048);
+
+		auto const number_of_global_allocations_before = number_of_global_allocations;
+		
+		auto request_with_memory_resource = std::move(request)
+			.set_memory_resource(&memory_resource)
+			.add_header({.name="X-After", .value=long_value})
+			.add_headers({Header{.name="X-Other", .value=long_value}, Header{.name="X-Last", .value=long_value}});
+		if (!is_body_set_first) {
+			std::move(request_with_memory_resource).set_body(body).serialize([&](std::span<std::byte const> const data) {
+				serialized_request += utils::data_to_string(data);
+			});
+		}
+		else {
+			std::move(request_with_memory_resource).serialize([&](std::span<std::byte const> const data) {
+				serialized_request += utils::data_to_string(data);
+			});
+		}
+
+		CHECK(number_of_global_allocations == number_of_global_allocations_before);
+		CHECK(serialized_request.starts_with("POST /a/long/path/that/does/not/fit/in/a/small/string HTTP/1.1\r\nHost: example.com\r\n"));
+		CHECK(serialized_request.find("X-Before: " + long_value) != std::pmr::string::npos);
+		CHECK(serialized_request.find("X-Last: " + long_value) != std::pmr::string::npos);
+		CHECK(serialized_request.ends_with("\r\n\r\n" + body));
+	}
+}
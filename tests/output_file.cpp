@@ -0,0 +1,27 @@
+#include "testing_header.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+TEST_CASE("utils::OutputFile writes data sequentially") {
+	auto const file_name = std::string{"output_file_test.txt"};
+	{
+		auto file = utils::OutputFile{file_name};
+		file.preallocate(1 << 16);
+		file.write(utils::string_to_data<std::byte>("Hello "sv));
+		file.write(utils::string_to_data<std::byte>(""sv));
+		file.write(utils::string_to_data<std::byte>("world!"sv));
+	}
+	auto contents = std::ostringstream{};
+	contents << std::ifstream{file_name, std::ios::binary}.rdbuf();
+	
+	// Preallocating space should not change the size of the file.
+	CHECK(contents.str() == "Hello world!");
+
+	std::remove(file_name.c_str());
+}
+
+TEST_CASE("utils::OutputFile with invalid path") {
+	CHECK_THROWS_AS(utils::OutputFile{"this/directory/does/not/exist/file.txt"}, std::system_error);
+}
@@ -0,0 +1,39 @@
+#include "testing_header.hpp"
+
+TEST_CASE("parse_content_range with a satisfied range") {
+	CHECK(algorithms::parse_content_range("bytes 0-499/1234") == algorithms::ContentRange{
+		.range = algorithms::ByteRange{.first = 0, .last = 499},
+		.complete_length = 1234,
+	});
+	CHECK(algorithms::parse_content_range("Bytes 21010-47021/47022") == algorithms::ContentRange{
+		.range = algorithms::ByteRange{.first = 21010, .last = 47021},
+		.complete_length = 47022,
+	});
+}
+
+TEST_CASE("parse_content_range with unknown complete length") {
+	CHECK(algorithms::parse_content_range("bytes 42-1233/*") == algorithms::ContentRange{
+		.range = algorithms::ByteRange{.first = 42, .last = 1233},
+		.complete_length{},
+	});
+}
+
+TEST_CASE("parse_content_range with an unsatisfied range") {
+	CHECK(algorithms::parse_content_range("bytes */1234") == algorithms::ContentRange{
+		.range{},
+		.complete_length = 1234,
+	});
+}
+
+TEST_CASE("parse_content_range with invalid values") {
+	CHECK(!algorithms::parse_content_range(""));
+	CHECK(!algorithms::parse_content_range("bytes */*"));
+	CHECK(!algorithms::parse_content_range("bytes 500-0/1234"));
+	CHECK(!algorithms::parse_content_range("items 0-4/5"));
+	CHECK(!algorithms::parse_content_range("bytes 0-4"));
+}
+
+TEST_CASE("byte_range_to_range_header_value") {
+	CHECK(algorithms::byte_range_to_range_header_value({.first = 0, .last = 0}) == "bytes=0-0");
+	CHECK(algorithms::byte_range_to_range_header_value({.first = 100, .last{}}) == "bytes=100-");
+}
@@ -48,3 +48,82 @@ Last-Modified - tomorrow at 4 am
 TEST_CASE("Trying parse_headers_string with empty string") {
 	CHECK(algorithms::parse_headers_string("").empty());
 }
+
+TEST_CASE("HeaderIndex finds the same headers as find_header_by_name") {
+	auto headers_string = std::string{};
+	for (auto i = 0; i < 40; ++i) {
+		headers_string += std::format("X-Header-{}: {}\n", i, i);
+	}
+	headers_string += "Set-Cookie: a\nSET-COOKIE: b\n";
+	auto const headers = algorithms::parse_headers_string(headers_string);
+	auto const index = algorithms::HeaderIndex{headers};
+
+	for (auto const& header : headers) {
+		CHECK(index.find(headers, header.name) == algorithms::find_header_by_name(headers, header.name));
+	}
+	REQUIRE(index.find(headers, "x-header-39"));
+	CHECK(index.find(headers, "x-header-39")->value == "39");
+	CHECK(index.find(headers, "set-cookie")->value == "a");
+	CHECK(!index.find(headers, "x-header-40"));
+	CHECK(!index.find(headers, ""));
+
+	auto const empty_headers = std::vector<Header>{};
+	CHECK(!algorithms::HeaderIndex{empty_headers}.find(empty_headers, "x"));
+}
+
+TEST_CASE("Known header names") {
+	STATIC_REQUIRE(algorithms::find_known_header("content-LENGTH") == KnownHeader::ContentLength);
+	STATIC_REQUIRE(!algorithms::find_known_header("content-lengths"));
+	
+	for (auto i = std::size_t{}; i < known_header_count; ++i) {
+		auto const known_header = static_cast<KnownHeader>(i);
+		CHECK(algorithms::find_known_header(known_header_to_string(known_header)) == known_header);
+	}
+	CHECK(!algorithms::find_known_header(""));
+	CHECK(!algorithms::find_known_header("X-Custom"));
+
+	auto const headers = algorithms::parse_headers_string("X-Custom: 1\nETAG: \"a\"\ncontent-length: 5\nEtag: \"b\"");
+	auto const index = algorithms::HeaderIndex{headers};
+	REQUIRE(index.find(headers, KnownHeader::ETag));
+	CHECK(index.find(headers, KnownHeader::ETag)->value == "\"a\"");
+	CHECK(index.find(headers, KnownHeader::ContentLength)->value == "5");
+	CHECK(!index.find(headers, KnownHeader::TransferEncoding));
+}
+
+TEST_CASE("parse_headers_string with folded lines") {
+	auto headers_string = std::string{"\r\nX-Folded: first\r\n  second\r\n\tthird \r\nOther: value\r\n"};
+
+	auto const folded_headers = algorithms::parse_headers_string(headers_string);
+	REQUIRE(folded_headers.size() == 2);
+	CHECK(folded_headers[0].value == "first\r\n  second\r\n\tthird");
+	CHECK(folded_headers[1] == Header{.name = "other", .value = "value"});
+
+	algorithms::unfold_header_lines(headers_string);
+	auto const unfolded_headers = algorithms::parse_headers_string(headers_string);
+	REQUIRE(unfolded_headers.size() == 2);
+	CHECK(unfolded_headers[0] == Header{.name = "x-folded", .value = "first    second  \tthird"});
+	CHECK(unfolded_headers[1] == Header{.name = "other", .value = "value"});
+
+	// A folded line without a header before it is ignored.
+	CHECK(algorithms::parse_headers_string(" folded: value\nOne: 1").size() == 1);
+}
+
+TEST_CASE("remove_header_lines_from_string") {
+	auto headers = std::string{
+		"\r\n"
+		"Content-Encoding: gzip\r\n"
+		"Accept: */*\r\n"
+		"content-encoding: zstd\r\n"
+		"Content-Encoding-Extra: 1\r\n"
+		"Content-Encoding: br"
+	};
+	algorithms::remove_header_lines_from_string(headers, "Content-Encoding");
+	CHECK(headers == "\r\nAccept: */*\r\nContent-Encoding-Extra: 1\r\n");
+
+	algorithms::remove_header_lines_from_string(headers, "accept");
+	CHECK(headers == "\r\nContent-Encoding-Extra: 1\r\n");
+
+	auto empty_headers = std::string{};
+	algorithms::remove_header_lines_from_string(empty_headers, "accept");
+	CHECK(empty_headers.empty());
+}
@@ -24,3 +24,20 @@ TEST_CASE("parse_status_line with empty string") {
     CHECK(status_code == StatusCode::Unknown);
     CHECK(status_message.empty()); 
 }
+TEST_CASE("parse_status_line with other HTTP versions") {
+    auto const http_1_0 = algorithms::parse_status_line("HTTP/1.0 404 Not Found\r\n");
+    CHECK(http_1_0.http_version == "HTTP/1.0");
+    CHECK(http_1_0.status_code == StatusCode::NotFound);
+    CHECK(http_1_0.status_message == "Not Found");
+
+    auto const http_2 = algorithms::parse_status_line("HTTP/2 200 OK");
+    CHECK(http_2.http_version == "HTTP/2");
+    CHECK(http_2.status_code == StatusCode::Ok);
+    CHECK(http_2.status_message == "OK");
+}
+TEST_CASE("parse_status_line with empty status message") {
+    auto const status_line = algorithms::parse_status_line("HTTP/1.1 204 \r\n");
+    CHECK(status_line.http_version == "HTTP/1.1");
+    CHECK(status_line.status_code == StatusCode::NoContent);
+    CHECK(status_line.status_message.empty());
+}
@@ -0,0 +1,93 @@
+#include "testing_header.hpp"
+
+/*
+	Returns the pieces of data that send would write to the server for the request.
+*/
+[[nodiscard]]
+std::vector<std::string> serialize_request(
+	PreparedRequest const& request,
+	std::span<Header const> const extra_headers = {},
+	std::optional<std::span<std::byte const>> const body = {}
+) {
+	auto pieces = std::vector<std::string>();
+	request.serialize(
+		[&](std::span<std::byte const> const data) { pieces.emplace_back(utils::data_to_string(data)); },
+		extra_headers, body
+	);
+	return pieces;
+}
+
+TEST_CASE("Prepared request serialization") {
+	SECTION("A request without a body") {
+		auto const request = get("http://example.com/path?a=b").add_header({.name="Accept", .value="*/*"}).prepare();
+		CHECK(serialize_request(request) == std::vector<std::string>{
+			"GET /path?a=b HTTP/1.1\r\nHost: example.com\r\nAccept: */*\r\n\r\n"
+		});
+	}
+	SECTION("A small body is sent together with the headers") {
+		auto const request = post("http://example.com/path").set_body("abc"sv).prepare();
+		CHECK(serialize_request(request) == std::vector<std::string>{
+			"POST /path HTTP/1.1\r\nHost: example.com\r\nTransfer-Encoding: identity\r\nContent-Length: 3\r\n\r\nabc"
+		});
+	}
+	SECTION("A big body is sent separately") {
+		auto const body = std::string(20'000, 'x');
+		auto const request = post("http://example.com/path").set_body(body).prepare();
+		CHECK(serialize_request(request) == std::vector<std::string>{
+			"POST /path HTTP/1.1\r\nHost: example.com\r\nTransfer-Encoding: identity\r\nContent-Length: 20000\r\n\r\n",
+			body
+		});
+	}
+	SECTION("A body whose upload progress is reported is sent separately") {
+		auto const request = post("http://example.com/path")
+			.set_body("abc"sv)
+			.set_upload_progress_callback([](RequestProgressBody const&) {})
+			.prepare();
+		CHECK(serialize_request(request) == std::vector<std::string>{
+			"POST /path HTTP/1.1\r\nHost: example.com\r\nTransfer-Encoding: identity\r\nContent-Length: 3\r\n\r\n",
+			"abc"
+		});
+	}
+}
+
+TEST_CASE("Prepared request serialization with extra headers and body overrides") {
+	auto const request = post("http://example.com/path")
+		.add_header({.name="Accept", .value="*/*"})
+		.set_body("abc"sv)
+		.prepare();
+
+	auto const extra_headers = std::array{
+		Header{.name="X-Request-Id", .value="1"},
+		Header{.name="X-Other", .value="2"},
+	};
+	CHECK(serialize_request(request, extra_headers) == std::vector<std::string>{
+		"POST /path HTTP/1.1\r\nHost: example.com\r\nAccept: */*\r\nX-Request-Id: 1\r\nX-Other: 2\r\n"
+		"Transfer-Encoding: identity\r\nContent-Length: 3\r\n\r\nabc"
+	});
+
+	auto const body_override = utils::string_to_data<std::byte>("hello"sv);
+	CHECK(serialize_request(request, {}, body_override) == std::vector<std::string>{
+		"POST /path HTTP/1.1\r\nHost: example.com\r\nAccept: */*\r\n"
+		"Transfer-Encoding: identity\r\nContent-Length: 5\r\n\r\nhello"
+	});
+
+	// An empty body override sends no body at all.
+	CHECK(serialize_request(request, extra_headers, std::span<std::byte const>{}) == std::vector<std::string>{
+		"POST /path HTTP/1.1\r\nHost: example.com\r\nAccept: */*\r\nX-Request-Id: 1\r\nX-Other: 2\r\n\r\n"
+	});
+
+	auto const big_body = std::string(20'000, 'y');
+	CHECK(serialize_request(request, extra_headers, utils::string_to_data<std::byte>(std::string_view{big_body})) == std::vector<std::string>{
+		"POST /path HTTP/1.1\r\nHost: example.com\r\nAccept: */*\r\nX-Request-Id: 1\r\nX-Other: 2\r\n"
+		"Transfer-Encoding: identity\r\nContent-Length: 20000\r\n\r\n",
+		big_body
+	});
+}
+
+TEST_CASE("Prepared request with a body view") {
+	auto const body = std::string{"viewed"};
+	auto const request = post("http://example.com/").set_body_view(body).prepare();
+	CHECK(serialize_request(request) == std::vector<std::string>{
+		"POST / HTTP/1.1\r\nHost: example.com\r\nTransfer-Encoding: identity\r\nContent-Length: 6\r\n\r\nviewed"
+	});
+}
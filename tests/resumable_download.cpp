@@ -0,0 +1,52 @@
+#include "testing_header.hpp"
+
+TEST_CASE("Resumable download state") {
+	auto const state = algorithms::download_state_to_string("\"abc\"");
+	CHECK(state == "If-Range: \"abc\"\n");
+	CHECK(algorithms::parse_download_state(state) == Header{.name="If-Range", .value="\"abc\""});
+
+	CHECK(algorithms::parse_download_state("if-range: Wed, 21 Oct 2015 07:28:00 GMT\r\n") == Header{.name="if-range", .value="Wed, 21 Oct 2015 07:28:00 GMT"});
+	CHECK(algorithms::parse_download_state("If-Range: \"abc\"\nsomething else") == Header{.name="If-Range", .value="\"abc\""});
+
+	CHECK_FALSE(algorithms::parse_download_state(""));
+	CHECK_FALSE(algorithms::parse_download_state("If-Range:\n"));
+	CHECK_FALSE(algorithms::parse_download_state("ETag: \"abc\"\n"));
+	CHECK_FALSE(algorithms::parse_download_state("garbage"));
+}
+
+TEST_CASE("Resumable download action") {
+	using algorithms::ResumableDownloadAction;
+	using algorithms::get_resumable_download_action;
+
+	auto const range = [](std::uint64_t const first, std::uint64_t const last, std::uint64_t const complete_length) {
+		return algorithms::ContentRange{.range = algorithms::ByteRange{.first = first, .last = last}, .complete_length = complete_length};
+	};
+
+	SECTION("The whole resource is sent") {
+		CHECK(get_resumable_download_action(StatusCode::Ok, {}, 0) == ResumableDownloadAction::Restart);
+		// The resource has changed, so the server ignored the Range header.
+		CHECK(get_resumable_download_action(StatusCode::Ok, {}, 500) == ResumableDownloadAction::Restart);
+	}
+	SECTION("The rest of the resource is sent") {
+		CHECK(get_resumable_download_action(StatusCode::PartialContent, range(500, 999, 1000), 500) == ResumableDownloadAction::Append);
+		CHECK(get_resumable_download_action(StatusCode::PartialContent, algorithms::ContentRange{.range = algorithms::ByteRange{.first = 500, .last = 999}, .complete_length{}}, 500)
+			== ResumableDownloadAction::Append);
+	}
+	SECTION("A different range is sent") {
+		CHECK(get_resumable_download_action(StatusCode::PartialContent, range(0, 999, 1000), 500) == ResumableDownloadAction::RangeMismatch);
+		CHECK(get_resumable_download_action(StatusCode::PartialContent, range(600, 999, 1000), 500) == ResumableDownloadAction::RangeMismatch);
+		CHECK(get_resumable_download_action(StatusCode::PartialContent, {}, 500) == ResumableDownloadAction::RangeMismatch);
+		// No range was requested.
+		CHECK(get_resumable_download_action(StatusCode::PartialContent, range(0, 999, 1000), 0) == ResumableDownloadAction::RangeMismatch);
+	}
+	SECTION("The file is already complete") {
+		auto const unsatisfied_range = algorithms::ContentRange{.range{}, .complete_length = 1000};
+		CHECK(get_resumable_download_action(StatusCode::RangeNotSatisfiable, unsatisfied_range, 1000) == ResumableDownloadAction::Complete);
+		CHECK(get_resumable_download_action(StatusCode::RangeNotSatisfiable, unsatisfied_range, 1200) == ResumableDownloadAction::Fail);
+		CHECK(get_resumable_download_action(StatusCode::RangeNotSatisfiable, {}, 1000) == ResumableDownloadAction::Fail);
+	}
+	SECTION("Error responses") {
+		CHECK(get_resumable_download_action(StatusCode::NotFound, {}, 0) == ResumableDownloadAction::Fail);
+		CHECK(get_resumable_download_action(StatusCode::InternalServerError, range(500, 999, 1000), 500) == ResumableDownloadAction::Fail);
+	}
+}
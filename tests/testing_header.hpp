@@ -13,4 +13,29 @@ auto const ok_status_line = StatusLine{
 	.status_message = "OK",
 };
 
+/*
+	Passes input to parser in packets of packet_size bytes, like they could be received from a socket.
+	The connection is closed after the last packet if the response has not ended before that.
+*/
+inline std::optional<algorithms::ParsedResponse> parse_in_packets(
+	algorithms::ResponseParser& parser, std::string_view const input, std::size_t const packet_size
+) {
+	auto const data = utils::string_to_data<std::byte>(input);
+	for (auto position = std::size_t{}; position < data.size(); position += packet_size) {
+		if (auto result = parser.parse_new_data(data.subspan(position, std::min(data.size() - position, packet_size)))) {
+			return result;
+		}
+	}
+	return parser.finish_at_connection_close();
+}
+/*
+	Like the other overload, with a new parser that uses options.
+*/
+inline std::optional<algorithms::ParsedResponse> parse_in_packets(
+	std::string_view const input, std::size_t const packet_size, algorithms::ResponseParsingOptions const options = {}
+) {
+	auto parser = algorithms::ResponseParser{options};
+	return parse_in_packets(parser, input, packet_size);
+}
+
 } // namespace test_utils
@@ -19,3 +19,26 @@ TEST_CASE("uri_encode with already encoded std::string_view") {
 TEST_CASE("uri_encode with empty string") {
     CHECK(utils::uri_encode(""sv) == "");
 }
+
+TEST_CASE("uri_encode_component") {
+    CHECK(utils::uri_encode_component("a b&c=d/é"sv) == "a%20b%26c%3Dd%2F%C3%A9");
+    CHECK(utils::uri_encode_component("Az09-._~"sv) == "Az09-._~");
+    CHECK(utils::uri_encode_component(std::string_view{"\0\xff", 2}) == "%00%FF");
+}
+
+TEST_CASE("uri_decode") {
+    CHECK(utils::uri_decode("https://pt.wikipedia.org/wiki/Codifica%c3%a7%c3%a3o_por_cento"sv) == 
+        "https://pt.wikipedia.org/wiki/Codificação_por_cento");
+    CHECK(utils::uri_decode("a%2Fb%2fc+d"sv) == "a/b/c+d");
+    CHECK(utils::uri_decode("100%"sv) == "100%");
+    CHECK(utils::uri_decode("%4"sv) == "%4");
+    CHECK(utils::uri_decode("%zz%41"sv) == "%zzA");
+    CHECK(utils::uri_decode(""sv) == "");
+
+    auto all_bytes = std::string(256, '\0');
+    for (auto i = 0; i < 256; ++i) {
+        all_bytes[static_cast<std::size_t>(i)] = static_cast<char>(i);
+    }
+    CHECK(utils::uri_decode(utils::uri_encode(all_bytes)) == all_bytes);
+    CHECK(utils::uri_decode(utils::uri_encode_component(all_bytes)) == all_bytes);
+}
@@ -0,0 +1,67 @@
+#include "testing_header.hpp"
+
+TEST_CASE("Url components") {
+	auto const url = Url{"https://www.google.com:8080/search?q=cpp#results"};
+	CHECK(url.get_protocol() == Protocol::Https);
+	CHECK(url.get_host() == "www.google.com");
+	CHECK(url.get_port() == 8080);
+	CHECK(url.get_path() == "/search?q=cpp#results");
+
+	auto const default_port_url = Url{"http://localhost/a/b"};
+	CHECK(default_port_url.get_port() == 80);
+	CHECK(default_port_url.get_path() == "/a/b");
+
+	auto const no_protocol_url = Url{"example.com", Protocol::Https};
+	CHECK(no_protocol_url.get_protocol() == Protocol::Https);
+	CHECK(no_protocol_url.get_port() == 443);
+	CHECK(no_protocol_url.get_host() == "example.com");
+	CHECK(no_protocol_url.get_path() == "/");
+
+	auto const encoded_url = Url{"http://example.com/a path"};
+	CHECK(encoded_url.get_string() == "http://example.com/a%20path");
+	CHECK(encoded_url.get_path() == "/a%20path");
+}
+
+TEST_CASE("Url copies are independent") {
+	auto url = std::optional<Url>{Url{"http://a.io/x"}};
+	auto const copy = *url;
+	url.reset();
+	CHECK(copy.get_host() == "a.io");
+	CHECK(copy.get_path() == "/x");
+	CHECK(copy.get_components().host == "a.io");
+}
+
+TEST_CASE("Url query parameters") {
+	auto url = Url{"https://api.example.com"};
+	url.add_query_parameter("name", "a b&c=d")
+		.add_query_parameter("path", "/x/y?");
+	CHECK(url.get_path() == "/?name=a%20b%26c%3Dd&path=%2Fx%2Fy%3F");
+	CHECK(url.get_string() == "https://api.example.com/?name=a%20b%26c%3Dd&path=%2Fx%2Fy%3F");
+
+	auto const with_fragment = Url{"http://example.com/page?a=1#top"}.add_query_parameter("b", "2");
+	CHECK(with_fragment.get_path() == "/page?a=1&b=2#top");
+
+	CHECK(utils::uri_encode_component("\xc3\xa5-._~") == "%C3%A5-._~");
+}
+
+TEST_CASE("Url literals") {
+	STATIC_REQUIRE(utils::split_url("https://a.io:8080/x").port == 8080);
+	STATIC_REQUIRE(utils::parse_port("65535") == 65535);
+	STATIC_REQUIRE(!utils::parse_port("65536"));
+	STATIC_REQUIRE(!utils::parse_port("80a"));
+
+	constexpr auto literal = "https://www.google.com:8080/search?q=cpp"_url;
+	STATIC_REQUIRE(literal.positions.protocol == Protocol::Https);
+	STATIC_REQUIRE(literal.positions.port == 8080);
+	STATIC_REQUIRE(literal.string.substr(literal.positions.host_offset, literal.positions.host_size) == "www.google.com");
+
+	auto const url = Url{literal};
+	CHECK(url == Url{"https://www.google.com:8080/search?q=cpp"});
+	CHECK(url.get_path() == "/search?q=cpp");
+
+	Url const default_protocol_url = "example.com"_url;
+	CHECK(default_protocol_url == Url{"example.com"});
+	CHECK(default_protocol_url.get_protocol() == Protocol::Http);
+	CHECK(default_protocol_url.get_port() == 80);
+	CHECK(default_protocol_url.get_path() == "/");
+}
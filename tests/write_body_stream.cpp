@@ -0,0 +1,107 @@
+#include "testing_header.hpp"
+
+/*
+	Returns a body source that produces body in pieces of piece_size bytes.
+*/
+[[nodiscard]]
+algorithms::BodySource make_body_source(std::string_view const body, std::size_t const piece_size) {
+	return [body, piece_size, position = std::size_t{}](std::span<std::byte> const buffer) mutable {
+		auto const size = std::min({piece_size, buffer.size(), body.size() - position});
+		std::ranges::copy(utils::string_to_data<std::byte>(body.substr(position, size)), buffer.begin());
+		position += size;
+		return size;
+	};
+}
+
+[[nodiscard]]
+std::string make_test_body(std::size_t const size) {
+	auto body = std::string(size, '\0');
+	for (auto i = std::size_t{}; i < size; ++i) {
+		body[i] = static_cast<char>('a' + i % 26);
+	}
+	return body;
+}
+
+TEST_CASE("write_body_stream with chunked transfer encoding") {
+	auto const body = make_test_body(40'000);
+
+	for (auto const piece_size : {std::size_t{1}, std::size_t{7}, algorithms::body_stream_piece_size}) {
+		auto const expected_body_size = piece_size == 1 ? std::size_t{100} : body.size();
+		auto const body_part = std::string_view{body}.substr(0, expected_body_size);
+
+		auto chunks = std::vector<std::string>();
+		auto progress = std::vector<std::size_t>();
+		algorithms::write_body_stream(
+			make_body_source(body_part, piece_size), {},
+			[&](std::span<std::byte const> const data) { chunks.emplace_back(utils::data_to_string(data)); },
+			[&](RequestProgressBody const& body_progress) {
+				CHECK_FALSE(body_progress.total_expected_body_size);
+				progress.push_back(body_progress.body_size_so_far);
+			}
+		);
+
+		// Every piece is passed on as one chunk, followed by the last chunk.
+		auto const piece_count = (body_part.size() + piece_size - 1)/piece_size;
+		REQUIRE(chunks.size() == piece_count + 1);
+		REQUIRE(progress.size() == piece_count);
+
+		for (auto i = std::size_t{}; i < piece_count; ++i) {
+			auto const piece = body_part.substr(i*piece_size, piece_size);
+			CHECK(chunks[i] == std::format("{:x}\r\n{}\r\n", piece.size(), piece));
+			CHECK(progress[i] == std::min((i + 1)*piece_size, body_part.size()));
+		}
+		CHECK(chunks.back() == "0\r\n\r\n");
+	}
+}
+
+TEST_CASE("write_body_stream with a body size") {
+	auto const body = make_test_body(40'000);
+
+	for (auto const piece_size : {std::size_t{7}, algorithms::body_stream_piece_size}) {
+		auto written_body = std::string{};
+		auto progress = std::vector<RequestProgressBody>();
+		algorithms::write_body_stream(
+			make_body_source(body, piece_size), body.size(),
+			[&](std::span<std::byte const> const data) { written_body += utils::data_to_string(data); },
+			[&](RequestProgressBody const& body_progress) { progress.push_back(body_progress); }
+		);
+		CHECK(written_body == body);
+
+		REQUIRE(progress.size() == (body.size() + piece_size - 1)/piece_size);
+		CHECK(progress.front().body_size_so_far == piece_size);
+		CHECK(progress.back().body_size_so_far == body.size());
+		CHECK(std::ranges::all_of(progress, [&](RequestProgressBody const& body_progress) {
+			return body_progress.total_expected_body_size == body.size();
+		}));
+	}
+}
+
+TEST_CASE("write_body_stream with a body source of the wrong size") {
+	auto const body = make_test_body(1000);
+	auto const ignore_output = [](std::span<std::byte const>) {};
+
+	CHECK_THROWS_AS(algorithms::write_body_stream(make_body_source(body, 100), body.size() - 1, ignore_output), std::length_error);
+	CHECK_THROWS_AS(algorithms::write_body_stream(make_body_source(body, 100), body.size() + 1, ignore_output), std::length_error);
+	CHECK_THROWS_AS(algorithms::write_body_stream(make_body_source({}, 100), std::size_t{1}, ignore_output), std::length_error);
+
+	// The body source claims to have written more than the buffer can hold.
+	auto const overflowing_source = [](std::span<std::byte> const buffer) { return buffer.size() + 1; };
+	CHECK_THROWS_AS(algorithms::write_body_stream(overflowing_source, {}, ignore_output), std::length_error);
+	CHECK_THROWS_AS(algorithms::write_body_stream(overflowing_source, std::size_t{100'000}, ignore_output), std::length_error);
+}
+
+TEST_CASE("write_body_stream with an empty body") {
+	auto output = std::string{};
+	auto const write_output = [&](std::span<std::byte const> const data) { output += utils::data_to_string(data); };
+	auto progress_count = 0;
+	auto const count_progress = [&](RequestProgressBody const&) { ++progress_count; };
+
+	algorithms::write_body_stream(make_body_source({}, 100), {}, write_output, count_progress);
+	CHECK(output == "0\r\n\r\n");
+
+	output.clear();
+	algorithms::write_body_stream(make_body_source({}, 100), std::size_t{}, write_output, count_progress);
+	CHECK(output.empty());
+
+	CHECK(progress_count == 0);
+}